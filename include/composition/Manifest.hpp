@@ -63,6 +63,10 @@ public:
    * If postPatching is true, what must be written to the patching manifest
    */
   std::string patchInfo;
+  /**
+   * Manifests sharing a variant group are alternative placements of one logical protection, at most one of them is kept
+   */
+  std::optional<size_t> variantGroup{};
 
 private:
   /**
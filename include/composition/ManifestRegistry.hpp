@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <string>
 #include <set>
+#include <vector>
 
 namespace composition {
 
@@ -19,6 +20,12 @@ public:
    */
   static void Add(Manifest *m);
 
+  /**
+   * Adds alternative placements of one logical protection to the registry. Conflict handling keeps at most one of them.
+   * @param variants the pointers to the `Manifest` variants
+   */
+  static void AddVariants(const std::vector<Manifest *> &variants);
+
   /**
    * Retrieves and returns all registered manifests.
    * @return an `unordered_set` of `Manifest` pointers
@@ -42,6 +49,11 @@ protected:
    */
   static manifest_idx_t index;
 
+  /**
+   * Strictly increasing counter of the next variant group
+   */
+  static size_t variantGroup;
+
   // TODO: This currently initializes a static unordered_set in the function. Possibly there's a better way to do this.
   static std::set<Manifest *> &RegisteredManifests();
 };
@@ -14,6 +14,7 @@ class Stats {
 public:
   metric::Stats stats{};
   size_t proposedManifests{};
+  size_t filteredManifests{};
   size_t actualManifests{};
   size_t cycles{};
   size_t conflicts{};
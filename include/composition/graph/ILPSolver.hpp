@@ -3,23 +3,47 @@
 
 #include <boost/bimap/bimap.hpp>
 #include <composition/Manifest.hpp>
+#include <composition/graph/ilp/Backend.hpp>
+#include <composition/graph/ilp/Model.hpp>
+#include <composition/graph/ilp/Objective.hpp>
+#include <composition/graph/ilp/Symmetry.hpp>
 #include <composition/metric/ManifestStats.hpp>
+#include <composition/metric/Weights.hpp>
 #include <composition/support/options.hpp>
 #include <functional>
-#include <glpk.h>
 #include <llvm/Support/Debug.h>
 #include <map>
+#include <memory>
+#include <optional>
 #include <set>
+#include <sstream>
 #include <vector>
 
 namespace composition::graph {
 using composition::Manifest;
 using composition::manifest_idx_t;
+using composition::graph::ilp::BoundType;
+using composition::graph::ilp::ColumnKind;
+using composition::graph::ilp::Direction;
 using composition::metric::ManifestStats;
 using composition::support::ILPBlockConnectivityBound;
 using composition::support::ILPConnectivityBound;
+using composition::support::ILPConnectivityCap;
 using llvm::dbgs;
 
+/**
+ * Upper bound on a cost the accepted manifests add to a part of the program, e.g. the estimated dynamic cost or the
+ * code size of a function
+ */
+struct OverheadBudget {
+  std::string name;
+  double limit;
+  /**
+   * Cost each manifest adds to the part
+   */
+  std::map<manifest_idx_t, double> costs;
+};
+
 class ILPSolver {
 private:
   int EXPLICIT{};
@@ -28,31 +52,144 @@ private:
   int HOTNESS_PROTECTEE{};
   int OVERHEAD{};
   int MANIFEST{};
-  enum Modes { minOverhead, maxExplicit, maxImplicit, maxConnectivity, maxManifest };
-  Modes ObjectiveMode{};
-  glp_prob *lp;
+  /**
+   * Bounds the weighted slack of the elastic rows to its minimum, 0 until `minimizeViolation` ran
+   */
+  int ELASTIC{};
+  std::unique_ptr<ilp::Objective> objective;
+  /**
+   * Columns the objective still has to set coefficients for, indexed by the column - 1
+   */
+  std::vector<ilp::ColumnTerm> terms{};
+  /**
+   * Contribution of each column to overhead and coverage, kept after the terms are added to the model
+   */
+  std::vector<std::pair<int, ilp::ColumnValues>> modeValues{};
+  ilp::Model model{};
+  std::unique_ptr<ilp::Backend> backend;
+  /**
+   * The model loaded into the backend if interchangeable manifests were collapsed
+   */
+  std::optional<ilp::Collapsed> collapsed{};
+  /**
+   * Columns of interchangeable manifests, collapsed for `-cf-ilp-break-symmetry`
+   */
+  std::vector<std::vector<int>> symmetryClasses{};
+  /**
+   * Slack column and its coefficient of each elastic bound row
+   */
+  std::map<int, std::pair<int, double>> slacks{};
   int cycleCount = 0;
+  int variantCount = 0;
   int connectivityCount = 0;
   int blockConnectivityCount = 0;
   int nOfCount = 0;
   int instructionCount = 0;
   int duplicateImplicitEdgeCount = 0;
   std::function<double(ManifestStats)> costFunction;
-  std::vector<int> rows{};
-  std::vector<int> cols{};
-  std::vector<double> coeffs{};
+  /**
+   * Weights of the coverage and connectivity objectives
+   */
+  metric::Weights weights{};
 
   boost::bimaps::bimap<int, manifest_idx_t> colsToM{};
   boost::bimaps::bimap<int, manifest_idx_t> colsToE{};
   boost::bimaps::bimap<int, manifest_idx_t> colsToF{};
   std::unordered_map<llvm::Instruction *, int> ItoCols{};
-  const std::string MANIFEST_OBJ = "manifest";
+  /**
+   * Names of the manifests, part of the cache key as the model itself only knows manifest indices
+   */
+  std::map<manifest_idx_t, std::string> manifestNames{};
+
+  /**
+   * Instructions covered by exactly the same set of manifests are interchangeable in the model. They share one
+   * coverage column whose coefficients are weighted by the number of instructions in the group.
+   */
+  struct CoverageGroup {
+    int col;
+    size_t weight;
+  };
+  std::map<std::set<manifest_idx_t>, CoverageGroup> coverageGroups{};
   const std::string OVERHEAD_OBJ = "overhead";
   const std::string EXPLICIT_OBJ = "explicit";
   const std::string IMPLICIT_OBJ = "implicit";
-  const std::string CONNECTIVITY_OBJ = "connectivity";
+
+  /**
+   * Everything besides the model that decides on the solution
+   */
+  std::string configuration(const ilp::Parameters &params) const;
+
+  /**
+   * Parameters of the MIP solves
+   */
+  ilp::Parameters solveParameters() const;
+
+  /**
+   * Maps the set columns of a solution to the accepted manifests and edges
+   */
+  std::pair<std::set<manifest_idx_t>, std::set<manifest_idx_t>> selection(const std::function<bool(int)> &isSet) const;
+
+  /**
+   * Overhead and coverage of the solution in instructions, summed over the columns instead of read from the bound rows
+   * or the objective, which are weighted by `-cf-weights`
+   */
+  ilp::ColumnValues solutionValues() const;
+
+  /**
+   * @return the value of a column of the model, also if a collapsed model was solved
+   */
+  double columnValue(int col) const;
+
+  /**
+   * @return the value of a column of the model in `values`, a solution of the loaded model indexed by the column - 1
+   */
+  double columnValue(int col, const std::vector<double> &values) const;
+
+  /**
+   * @return the indices of the manifests accepted by `values`, a solution of the loaded model indexed by the column - 1
+   */
+  std::vector<uint64_t> acceptedManifests(const std::vector<double> &values) const;
+
+  /**
+   * @return the value of a row without its elastic slack
+   */
+  double rowValue(int row) const;
+
+  /**
+   * Adds a slack to a bound row (`-cf-ilp-elastic`), bounds which cannot be met are violated instead of making the
+   * model infeasible
+   */
+  void elastic(int row);
+
+  /**
+   * Solves for the least violation of the elastic rows, relative to their bounds, and limits the slacks to it. The
+   * objective is then optimized among the solutions with that violation, whatever its scale. Only needed once `run`
+   * found the model infeasible with the slacks fixed at 0.
+   */
+  void minimizeViolation(const ilp::Parameters &params);
+
+  /**
+   * Logs the coverage and overhead of the solution and what else the objective reports
+   */
+  void printModeILPResults() const;
+
+  /**
+   * Logs the elastic bounds which are violated by the solution
+   */
+  void printViolatedBounds() const;
+
+  /**
+   * Solves copies of `loaded` with different branch-and-bound settings concurrently (`-cf-ilp-portfolio`). The first
+   * proven optimal run cancels the others, otherwise the best incumbent wins. The winning solution is read into the
+   * backend.
+   * @return the status of the winning run
+   */
+  ilp::Status portfolio(const ilp::Parameters &params, const ilp::Model &loaded);
 
 public:
+  /**
+   * Creates a solver which solves the model with the backend selected by `-cf-ilp-backend`
+   */
   ILPSolver();
 
   virtual ~ILPSolver();
@@ -71,6 +208,8 @@ public:
 
   void addCycles(const std::set<std::set<manifest_idx_t>> &cycles);
 
+  void addVariantGroups(const std::set<std::set<manifest_idx_t>> &groups);
+
   void addConnectivity(const std::set<std::set<manifest_idx_t>> &connectivities);
 
   void addBlockConnectivity(const std::set<std::set<manifest_idx_t>> &blockConnectivities);
@@ -79,77 +218,81 @@ public:
 
   void addUndoDependencies(const std::unordered_map<manifest_idx_t, Manifest *> &manifests);
 
+  void addOverheadBudgets(const std::vector<OverheadBudget> &budgets);
+
+  /**
+   * Registers classes of interchangeable manifests, must come after `addManifests`
+   */
+  void addSymmetryClasses(const std::vector<std::vector<manifest_idx_t>> &classes);
+
   void setCostFunction(std::function<double(ManifestStats)> f) { this->costFunction = f; }
 
+  void setWeights(const metric::Weights &w) { this->weights = w; }
+
   std::pair<std::set<manifest_idx_t>, std::set<manifest_idx_t>> run();
 
+  /**
+   * Re-solves the model loaded by `run` for each bound of `-cf-ilp-sweep` and dumps the resulting Pareto table. Each
+   * point starts from the solution of the previous one. The configured bound is restored afterwards, the solution in
+   * the backend is the one of the last point.
+   */
+  void sweep();
+
+  /**
+   * Solves the LP relaxation of the model
+   * @param method the LP algorithm
+   * @return the fractional value of each manifest and the objective value, a bound on the one of the ILP
+   */
+  std::pair<std::map<manifest_idx_t, double>, double> relax(ilp::LPMethod method);
+
   void conflict(std::pair<manifest_idx_t, manifest_idx_t> pair);
 
   void dependency(std::pair<manifest_idx_t, manifest_idx_t> pair);
 
   void cycle(const std::set<manifest_idx_t> &ms);
 
-  void setMode(const std::string &obj) {
-    if (obj == OVERHEAD_OBJ) {
-      ObjectiveMode = minOverhead;
-    } else if (obj == EXPLICIT_OBJ) {
-      ObjectiveMode = maxExplicit;
-    } else if (obj == IMPLICIT_OBJ) {
-      ObjectiveMode = maxImplicit;
-    } else if (obj == CONNECTIVITY_OBJ) {
-      ObjectiveMode = maxConnectivity;
-    } else if (obj == MANIFEST_OBJ) {
-      ObjectiveMode = maxManifest;
-    } else {
-      // default is minOverhead
-      ObjectiveMode = minOverhead;
-    }
-  }
+  void variantGroup(const std::set<manifest_idx_t> &ms);
+
+  /**
+   * Constrains the binary column `col` to be 1 iff any of the manifests `ms` is accepted. The tight formulation uses
+   * `col <= m1 + .. + mN` and `col >= mj`, the legacy one a single aggregated row with weak LP relaxation.
+   */
+  void anyOf(int col, const std::set<manifest_idx_t> &ms, const std::string &name);
 
   void edgeConnection(manifest_idx_t edgeInx, std::pair<manifest_idx_t, manifest_idx_t> pair) {
     // e0 depends on m1 and m2; 0 <= m1 + m2 -2 e0 <= 1
-    auto row = glp_add_rows(lp, 1);
-    glp_set_row_bnds(lp, row, GLP_DB, 0.0, 1.0);
+    auto row = model.addRow();
+    model.setRowBounds(row, BoundType::Double, 0.0, 1.0);
     std::ostringstream os;
     os << "edge_" << edgeInx << "_" << pair.first << "_" << pair.second;
-    glp_set_row_name(lp, row, os.str().c_str());
+    model.setRowName(row, os.str());
 
-    rows.push_back(row);
-    cols.push_back(colsToM.right.at(pair.first));
-    coeffs.push_back(1.0);
+    model.addCoefficient(row, colsToM.right.at(pair.first), 1.0);
 
-    rows.push_back(row);
-    cols.push_back(colsToM.right.at(pair.second));
-    coeffs.push_back(1.0);
+    model.addCoefficient(row, colsToM.right.at(pair.second), 1.0);
 
-    rows.push_back(row);
-    cols.push_back(colsToE.right.at(edgeInx));
-    coeffs.push_back(-2.0);
+    model.addCoefficient(row, colsToE.right.at(edgeInx), -2.0);
   }
 
   void duplicateImplicitEdge(manifest_idx_t fInx, const std::set<manifest_idx_t> &edgeDuplicates) {
     // f0 is set if any of the duplicate edges are set (i.e. OR): 0 <= 2f0 - e1 - e2 <=1
-    auto row = glp_add_rows(lp, 1);
-    glp_set_row_bnds(lp, row, GLP_DB, 0.0, std::max(size_t(1), edgeDuplicates.size() - 1));
+    auto row = model.addRow();
+    model.setRowBounds(row, BoundType::Double, 0.0, std::max(size_t(1), edgeDuplicates.size() - 1));
     std::ostringstream os;
     os << "f" << fInx; //<< "_" << edgeDuplicates.size();
     /*for (auto edgeIndex : edgeDuplicates) {
       os << "_" << edgeIndex;
     }*/
     os << "_" << duplicateImplicitEdgeCount;
-    glp_set_row_name(lp, row, os.str().c_str());
+    model.setRowName(row, os.str());
 
-    rows.push_back(row);
-    cols.push_back(colsToF.right.at(fInx));
-    coeffs.push_back(
-        std::max(size_t(2), edgeDuplicates.size())); // even when there is one edge f need to have a coefficent 2
+    // even when there is one edge f need to have a coefficent 2
+    model.addCoefficient(row, colsToF.right.at(fInx), std::max(size_t(2), edgeDuplicates.size()));
 
     //llvm::dbgs() << "Duplicates edges covering manifest " << fInx << ":\n";
     for (auto edgeIndex : edgeDuplicates) {
       //llvm::dbgs() << edgeIndex << ",";
-      rows.push_back(row);
-      cols.push_back(colsToE.right.at(edgeIndex));
-      coeffs.push_back(-1.0);
+      model.addCoefficient(row, colsToE.right.at(edgeIndex), -1.0);
     }
     //llvm::dbgs() << "\n";
   }
@@ -158,234 +301,45 @@ public:
 
   void blockConnectivity(const std::set<manifest_idx_t> &ms, double targetBlockConnectivity);
 
-  void explicitCoverage(llvm::Instruction *I, const std::set<manifest_idx_t> &ms);
-
-  double get_obj_coef_manifest(double overheadValue) {
-    //this is only called for manifests and thus no implicit/explicit value is needed,
-    //implicit/explicit values are only on edges not manifests!
-    switch (ObjectiveMode) {
-    case minOverhead:return overheadValue;
-    case maxManifest:return 1; //every manifest has weight of 1
-    default:return 0;
-      // TODO: case maxConnectivity:
-      // return connectivity is not a column yet!
-    }
-  }
-  double get_obj_coef_edge(long unsigned int coverage) {
-    switch (ObjectiveMode) {
-    case maxImplicit:return coverage;
-    default:return 0;
-    }
-  }
+  int explicitCoverage(const std::set<manifest_idx_t> &ms, size_t weight);
 
-  double get_obj_coef_explicit(long unsigned int coverage) {
-    switch (ObjectiveMode) {
-    case maxExplicit:return coverage;
-    default:return 0;
-    }
-  }
+  void connectivityCoverage(const std::set<manifest_idx_t> &ms, const CoverageGroup &group);
 
-  int get_obj_dir() {
-    switch (ObjectiveMode) {
-    case minOverhead:return GLP_MIN;
-    default:return GLP_MAX;
+  /**
+   * @return the objective term of `col`, applied by `addObjectiveColumns`
+   */
+  ilp::ColumnTerm &term(int col) {
+    if (terms.size() < static_cast<size_t>(col)) {
+      terms.resize(static_cast<size_t>(col));
     }
+    auto &t = terms[col - 1];
+    t.col = col;
+    return t;
   }
-  void printModeILPResults() {
-    std::string objective;
-    uint64_t explicit_re = 0;
-    uint64_t implicit_re = 0;
-    double overhead_re = 0.0;
-    double connectivity = 0.0;
-
-    switch (ObjectiveMode) {
-    case minOverhead:objective = "min Overhead. ";
-      explicit_re = (uint64_t) glp_mip_row_val(lp, EXPLICIT);
-      implicit_re = (uint64_t) glp_mip_row_val(lp, IMPLICIT);
-      overhead_re = (double) glp_mip_obj_val(lp);
-      break;
-    case maxExplicit:objective = "max Explicit. ";
-      explicit_re = (uint64_t) glp_mip_obj_val(lp);
-      implicit_re = (uint64_t) glp_mip_row_val(lp, IMPLICIT);
-      overhead_re = (double) glp_mip_row_val(lp, OVERHEAD);
-      break;
-    case maxImplicit:objective = "max Implicit. ";
-      explicit_re = (uint64_t) glp_mip_row_val(lp, EXPLICIT);
-      overhead_re = (double) glp_mip_row_val(lp, OVERHEAD);
-      implicit_re = (uint64_t) glp_mip_obj_val(lp);
-      break;
-    case maxConnectivity:objective = "max Connectivity. ";
-      // TODO: print for connectivity
-      break;
-    case maxManifest:objective = "max manifest. ";
-      break;
-    default:break;
-    }
 
-    llvm::dbgs() << "ILP resuls. " << objective << " overhead: " << overhead_re << " explicit instruction coverage: "
-                 << explicit_re << " implicit instruction coverage: " << implicit_re << "\n";
-  }
-  void addModeRows(double overheadBound,
-                   int explicitBound,
-                   int implicitBound,
-                   double hotness,
-                   double hotnessProtectee) {
-    switch (ObjectiveMode) {
-    case minOverhead:
-      // row 1
-      EXPLICIT = glp_add_rows(lp, 1);
-      glp_set_row_name(lp, EXPLICIT, "explicit");                 // assigns name p to first row
-      glp_set_row_bnds(lp, EXPLICIT, GLP_LO, explicitBound, 0.0); // 0 < explicit <= inf
-      // row 2
-      IMPLICIT = glp_add_rows(lp, 1);
-      glp_set_row_name(lp, IMPLICIT, "implicit");                 // assigns name q to second row
-      glp_set_row_bnds(lp, IMPLICIT, GLP_LO, implicitBound, 0.0); // 0 < implicit <= inf
-
-      MANIFEST = glp_add_rows(lp, 1);
-      glp_set_row_name(lp, MANIFEST, "manifest");
-      glp_set_row_bnds(lp, MANIFEST, GLP_LO, 0.0, 0.0);
-      break;
-    case maxExplicit:
-      // row 1
-      IMPLICIT = glp_add_rows(lp, 1);
-      glp_set_row_name(lp, IMPLICIT, "implicit");                 // assigns name q to second row
-      glp_set_row_bnds(lp, IMPLICIT, GLP_LO, implicitBound, 0.0); // 0 < implicit <= inf
-      //row 2
-      OVERHEAD = glp_add_rows(lp, 1);
-      glp_set_row_name(lp, OVERHEAD, "overhead");                 // assigns name p to first row
-      if (overheadBound > 0) {
-        glp_set_row_bnds(lp, OVERHEAD, GLP_UP, 0.0, overheadBound); // 0 < overhead <= inf
-      } else {
-        glp_set_row_bnds(lp, OVERHEAD, GLP_LO, overheadBound, 0); // 0 < overhead <= inf
-      }
-      MANIFEST = glp_add_rows(lp, 1);
-      glp_set_row_name(lp, MANIFEST, "manifest");
-      glp_set_row_bnds(lp, MANIFEST, GLP_LO, 0.0, 0.0);
-      break;
-    case maxImplicit:
-      // row 1
-      EXPLICIT = glp_add_rows(lp, 1);
-      glp_set_row_name(lp, EXPLICIT, "explicit");                 // assigns name p to first row
-      glp_set_row_bnds(lp, EXPLICIT, GLP_LO, explicitBound, 0.0); // 0 < explicit <= inf
-      // row 2
-      OVERHEAD = glp_add_rows(lp, 1);
-      glp_set_row_name(lp, OVERHEAD, "overhead");                 // assigns name p to first row
-      if (overheadBound > 0) {
-        glp_set_row_bnds(lp, OVERHEAD, GLP_UP, 0.0, overheadBound); // 0 < overhead <= inf
-      } else {
-        glp_set_row_bnds(lp, OVERHEAD, GLP_LO, overheadBound, 0); // 0 < overhead <= inf
-      }
-      MANIFEST = glp_add_rows(lp, 1);
-      glp_set_row_name(lp, MANIFEST, "manifest");
-      glp_set_row_bnds(lp, MANIFEST, GLP_LO, 0.0, 0.0);
-      break;
-    case maxManifest:
-      // row 1
-      EXPLICIT = glp_add_rows(lp, 1);
-      glp_set_row_name(lp, EXPLICIT, "explicit");                 // assigns name p to first row
-      glp_set_row_bnds(lp, EXPLICIT, GLP_LO, explicitBound, 0.0); // 0 < explicit <= inf
-      // row 2
-      IMPLICIT = glp_add_rows(lp, 1);
-      glp_set_row_name(lp, IMPLICIT, "implicit");                 // assigns name q to second row
-      glp_set_row_bnds(lp, IMPLICIT, GLP_LO, implicitBound, 0.0); // 0 < implicit <= inf
-      // row 3
-      OVERHEAD = glp_add_rows(lp, 1);
-      glp_set_row_name(lp, OVERHEAD, "overhead");                 // assigns name p to first row
-      if (overheadBound > 0) {
-        glp_set_row_bnds(lp, OVERHEAD, GLP_UP, 0.0, overheadBound); // 0 < overhead <= inf
-      } else {
-        glp_set_row_bnds(lp, OVERHEAD, GLP_LO, overheadBound, 0); // 0 < overhead <= inf
-      }
-      break;
+  /**
+   * Sets the objective coefficients and bound row coefficients of all columns added since the last call, in one pass
+   * specialized for the objective
+   */
+  void addObjectiveColumns();
 
-    case maxConnectivity:
-      // TODO: maximize connectivity?
-    default:break;
-    }
-    // row 3
-    HOTNESS = glp_add_rows(lp, 1);
-    glp_set_row_name(lp, HOTNESS, "hotness");            // assigns name q to second row
-    glp_set_row_bnds(lp, HOTNESS, GLP_LO, hotness, 0.0); // 0 < unique <= inf
-    // row 4
-    HOTNESS_PROTECTEE = glp_add_rows(lp, 1);
-    glp_set_row_name(lp, HOTNESS_PROTECTEE, "hotnessProtectee");            // assigns name q to second row
-    glp_set_row_bnds(lp, HOTNESS_PROTECTEE, GLP_LO, hotnessProtectee, 0.0); // 0 < unique <= inf
-  }
+  /**
+   * Adds the coefficients of `col` to the bound rows of the objective and to the hotness rows
+   */
   void addModeColumns(const int col, const double overheadValue, const int explicitValue, const int implicitValue,
                       const double hotnessValue, const double blockHotnessValue, const int manifestValue) {
-    switch (ObjectiveMode) {
-    case minOverhead:
-      // explicit
-      rows.push_back(EXPLICIT);
-      cols.push_back(col);
-      coeffs.push_back(explicitValue);
-
-      rows.push_back(IMPLICIT);
-      cols.push_back(col);
-      coeffs.push_back(implicitValue);
-
-      rows.push_back(MANIFEST);
-      cols.push_back(col);
-      coeffs.push_back(manifestValue);
-
-      break;
-    case maxExplicit:
-      // implicit
-      rows.push_back(IMPLICIT);
-      cols.push_back(col);
-      coeffs.push_back(implicitValue);
-      // overhead
-      rows.push_back(OVERHEAD);
-      cols.push_back(col);
-      coeffs.push_back(overheadValue);
-
-      rows.push_back(MANIFEST);
-      cols.push_back(col);
-      coeffs.push_back(manifestValue);
-      break;
-    case maxImplicit:
-      // explicit
-      rows.push_back(EXPLICIT);
-      cols.push_back(col);
-      coeffs.push_back(explicitValue);
-      // overhead
-      rows.push_back(OVERHEAD);
-      cols.push_back(col);
-      coeffs.push_back(overheadValue);
-
-      rows.push_back(MANIFEST);
-      cols.push_back(col);
-      coeffs.push_back(manifestValue);
-      break;
-    case maxManifest:
-      // explicit
-      rows.push_back(EXPLICIT);
-      cols.push_back(col);
-      coeffs.push_back(explicitValue);
-
-      // manifest has no implicit coverage but edges do
-      rows.push_back(IMPLICIT);
-      cols.push_back(col);
-      coeffs.push_back(implicitValue);
-      // overhead
-      rows.push_back(OVERHEAD);
-      cols.push_back(col);
-      coeffs.push_back(overheadValue);
-      break;
-
-    case maxConnectivity:
-      // TODO: maximize connectivity?
-    default:break;
+    auto &t = term(col);
+    t.bounded = true;
+    t.values = {overheadValue, static_cast<double>(explicitValue), static_cast<double>(implicitValue),
+                static_cast<double>(manifestValue)};
+    if (overheadValue != 0 || explicitValue != 0 || implicitValue != 0) {
+      modeValues.emplace_back(col, t.values);
     }
     // hotness
-    rows.push_back(HOTNESS);
-    cols.push_back(col);
-    coeffs.push_back(hotnessValue);
+    model.addCoefficient(HOTNESS, col, hotnessValue);
 
     // hotnessProtectee
-    rows.push_back(HOTNESS_PROTECTEE);
-    cols.push_back(col);
-    coeffs.push_back(blockHotnessValue);
+    model.addCoefficient(HOTNESS_PROTECTEE, col, blockHotnessValue);
   }
 
   void addImplicitCoverage(
@@ -400,12 +354,12 @@ public:
       //llvm::dbgs() << "edge" << eIdx << "_" << pair.first << "_" << pair.second << "\n";
       std::ostringstream os;
       os << "e" << eIdx;
-      auto col = glp_add_cols(lp, 1);
-      glp_set_col_name(lp, col, os.str().c_str()); // assigns name m_n to nth column
+      auto col = model.addColumn();
+      model.setColumnName(col, os.str()); // assigns name m_n to nth column
 
-      glp_set_col_kind(lp, col, GLP_BV);           // values are binary
-      glp_set_col_bnds(lp, col, GLP_DB, 0.0, 1.0); // values are binary
-      glp_set_obj_coef(lp, col, 0);                // TODO: edges do not impose any costs
+      model.setColumnKind(col, ColumnKind::Binary); // values are binary
+      model.setColumnBounds(col, BoundType::Double, 0.0, 1.0); // values are binary
+      model.setObjective(col, 0);                // TODO: edges do not impose any costs
 
       colsToE.insert({col, eIdx});
 
@@ -418,12 +372,13 @@ public:
       //llvm::dbgs() << "f" << mIdx;
       std::ostringstream os;
       os << "f" << mIdx;
-      auto col = glp_add_cols(lp, 1);
-      glp_set_col_name(lp, col, os.str().c_str()); // assigns name m_n to nth column
+      auto col = model.addColumn();
+      model.setColumnName(col, os.str()); // assigns name m_n to nth column
 
-      glp_set_col_kind(lp, col, GLP_BV);                      // values are binary
-      glp_set_col_bnds(lp, col, GLP_DB, 0.0, 1.0);            // values are binary
-      glp_set_obj_coef(lp, col, get_obj_coef_edge(coverage)); // TODO: f (edge duplicates) do not impose any costs
+      model.setColumnKind(col, ColumnKind::Binary); // values are binary
+      model.setColumnBounds(col, BoundType::Double, 0.0, 1.0); // values are binary
+      term(col).role = ilp::ColumnRole::Implicit; // TODO: f (edge duplicates) do not impose any costs
+      term(col).coverage = coverage;
 
       colsToF.insert({col, mIdx});
       addModeColumns(col, 0, 0, coverage, 0, 0, 0);
@@ -442,8 +397,7 @@ public:
     // implicitCoverageConstraint(implicitCoverageToInstruction, implicitCov, 0.0);
   }
 
-  void addNewImplicitCoverage(const std::map<llvm::Instruction *, std::set<manifest_idx_t>> &coverage,
-                              std::unordered_map<manifest_idx_t, std::set<manifest_idx_t>> implicitManifestEdges) {
+  void addNewImplicitCoverage(const std::unordered_map<manifest_idx_t, std::set<manifest_idx_t>> &implicitManifestEdges) {
     // Rules
     /**
      * (1) For each instruction (i_i) that is explicitly covered, introduce a copied implicit instruction variable (implicit_i)
@@ -481,10 +435,13 @@ public:
      * Three manifests: 3 * -f_mj_mk + 3 * implicit_i - implicit_i_row = 0; 0 <= implicit_i_row <= 2
      */
 
+    // The implicit manifests only depend on the manifests covering i_i. Thus, the rules are applied once per coverage
+    // group and the implicit column is weighted by the number of instructions in the group.
+
     // Apply (4)
 
-    // ms is the set that protects i implicitly
-    for (auto[instr, ms] : coverage) {
+    // ms is the set that protects the group implicitly
+    for (auto &[ms, group] : coverageGroups) {
       std::set<manifest_idx_t> implicitlyCoversInstr{};
 
       for (auto m : ms) {
@@ -501,47 +458,32 @@ public:
         continue;
       }
 
-      auto explicitCol = ItoCols.at(instr);
+      auto explicitCol = group.col;
       std::ostringstream os;
-      os << "implicit_" << glp_get_col_name(lp, explicitCol);
+      os << "implicit_" << model.columnName(explicitCol);
 
-      auto col = glp_add_cols(lp, 1);
+      auto col = model.addColumn();
 
-      glp_set_col_name(lp, col, os.str().c_str()); // assigns name m_n to nth column
-      glp_set_col_kind(lp, col, GLP_BV);                      // values are binary
-      glp_set_col_bnds(lp, col, GLP_DB, 0.0, 1.0);            // values are binary
-      glp_set_obj_coef(lp, col, get_obj_coef_edge(1));
+      model.setColumnName(col, os.str()); // assigns name m_n to nth column
+      model.setColumnKind(col, ColumnKind::Binary); // values are binary
+      model.setColumnBounds(col, BoundType::Double, 0.0, 1.0); // values are binary
+      term(col).role = ilp::ColumnRole::Implicit;
+      term(col).coverage = group.weight;
 
-      addModeColumns(col, 0, 0, 1 /*implicit cov of instruction*/, 0, 0, 0);
+      addModeColumns(col, 0, 0, group.weight /*implicit cov of instructions*/, 0, 0, 0);
 
 
       // Apply (1-3)
-      auto row = glp_add_rows(lp, 1);
-      glp_set_row_bnds(lp, row, GLP_UP, 0.0, 0.0);
-      glp_set_row_name(lp, row, os.str().c_str());
+      auto row = model.addRow();
+      model.setRowBounds(row, BoundType::Upper, 0.0, 0.0);
+      model.setRowName(row, os.str());
 
-      rows.push_back(row);
-      cols.push_back(col);
-      coeffs.push_back(1.0);
+      model.addCoefficient(row, col, 1.0);
 
-      rows.push_back(row);
-      cols.push_back(explicitCol);
-      coeffs.push_back(-1.0);
+      model.addCoefficient(row, explicitCol, -1.0);
       
-      auto orRow = glp_add_rows(lp, 1);
       os << "_row";
-      glp_set_row_name(lp, orRow, os.str().c_str());
-      glp_set_row_bnds(lp, orRow, GLP_DB, 0.0, std::max(size_t(1), implicitlyCoversInstr.size() - 1));
-
-      rows.push_back(orRow);
-      cols.push_back(col);
-      coeffs.push_back(std::max(size_t(2), implicitlyCoversInstr.size()));
-
-      for (auto m : implicitlyCoversInstr) {
-        rows.push_back(orRow);
-        cols.push_back(colsToM.right.at(m));
-        coeffs.push_back(-1.0);
-      }
+      anyOf(col, implicitlyCoversInstr, os.str());
     }
   }
 
@@ -557,20 +499,16 @@ public:
       }
 
       // mX cannot exist without N of m1...mK -> m1 + ... + mK - mX >= (N - 1)
-      auto row = glp_add_rows(lp, 1);
-      glp_set_row_bnds(lp, row, GLP_LO, N - 1, 0.0);
+      auto row = model.addRow();
+      model.setRowBounds(row, BoundType::Lower, N - 1, 0.0);
       std::ostringstream os;
       os << "n_" << N << "_of_" << nOfCount++;
-      glp_set_row_name(lp, row, os.str().c_str());
+      model.setRowName(row, os.str());
 
-      rows.push_back(row);
-      cols.push_back(colsToM.right.at(mIdx));
-      coeffs.push_back(-1.0);
+      model.addCoefficient(row, colsToM.right.at(mIdx), -1.0);
 
       for (auto idx : nOf.second) {
-        rows.push_back(row);
-        cols.push_back(colsToM.right.at(idx));
-        coeffs.push_back(1.0);
+        model.addCoefficient(row, colsToM.right.at(idx), 1.0);
       }
     }
   }
@@ -6,11 +6,15 @@
 #include <boost/bimap/bimap.hpp>
 #include <boost/bimap/unordered_set_of.hpp>
 #include <composition/ManifestRegistry.hpp>
+#include <composition/graph/ILPSolver.hpp>
+#include <composition/graph/algorithm/greedy.hpp>
 #include <composition/graph/constraint/constraint.hpp>
 #include <composition/graph/constraint/true.hpp>
 #include <composition/graph/util/dot.hpp>
 #include <composition/graph/util/graphml.hpp>
+#include <composition/metric/ManifestStats.hpp>
 #include <composition/metric/Performance.hpp>
+#include <composition/metric/Weights.hpp>
 #include <composition/profiler.hpp>
 #include <composition/support/options.hpp>
 #include <composition/util/bimap.hpp>
@@ -31,11 +35,13 @@
 #include <utility>
 
 namespace composition::graph {
+using composition::graph::algorithm::Greedy;
 using composition::graph::constraint::Constraint;
 using composition::graph::constraint::constraint_idx_t;
 using composition::graph::constraint::True;
 using composition::graph::util::graph_to_dot;
 using composition::graph::util::graph_to_graphml;
+using composition::metric::ManifestStats;
 using composition::metric::Performance;
 using composition::support::cStats;
 
@@ -112,6 +118,38 @@ private:
       vertex_idx_t s, vertex_idx_t d,
       const std::unordered_map<constraint::constraint_idx_t, std::shared_ptr<constraint::Constraint>> &constraints);
 
+  /**
+   * Everything the ILP model is built from, computed once per conflict handling
+   */
+  struct ILPInput {
+    std::set<std::pair<manifest_idx_t, manifest_idx_t>> conflicts{};
+    std::set<std::pair<manifest_idx_t, manifest_idx_t>> dependencies{};
+    std::set<std::set<manifest_idx_t>> variants{};
+    std::set<std::set<manifest_idx_t>> cycles{};
+    std::map<llvm::Instruction *, std::set<manifest_idx_t>> exactCoverage{};
+    std::set<std::set<manifest_idx_t>> connectivities{};
+    std::set<std::set<manifest_idx_t>> blockConnectivities{};
+    std::unordered_map<manifest_idx_t, std::set<manifest_idx_t>> implicitManifestEdges{};
+    std::map<manifest_idx_t, ManifestStats> mStats{};
+    std::vector<std::pair<manifest_idx_t, std::pair<uint64_t, std::vector<manifest_idx_t>>>> nOfs{};
+    std::vector<OverheadBudget> budgets{};
+    /**
+     * Interchangeable manifests, only computed for `-cf-ilp-break-symmetry`
+     */
+    std::vector<std::vector<manifest_idx_t>> symmetryClasses{};
+  };
+
+  ILPInput prepareILP(llvm::Module &M, const std::unordered_map<llvm::BasicBlock *, uint64_t> &BFI,
+                      const metric::Weights &weights);
+
+  void populateILP(ILPSolver &solver, const ILPInput &input, const metric::Weights &weights);
+
+  /**
+   * Groups manifests that can be swapped without changing the ILP: same protection, stats, covered instructions, undo
+   * coverage groups, neighbours and budget costs. Members of variant groups, n-of dependencies and cycles are left out.
+   */
+  std::vector<std::vector<manifest_idx_t>> symmetryClasses(const ILPInput &input);
+
 public:
   ProtectionGraph();
 
@@ -186,11 +224,34 @@ public:
   void computeManifestDependencies();
 
   std::set<std::pair<manifest_idx_t, manifest_idx_t>> vertexConflicts();
+  /**
+   * Groups the manifests registered as alternative placements of the same protection. Only groups with more than one
+   * manifest left are returned.
+   */
+  std::set<std::set<manifest_idx_t>> variantGroups();
+  /**
+   * Pairwise conflicts between the members of each variant group, for strategies that only handle pairs
+   */
+  std::set<std::pair<manifest_idx_t, manifest_idx_t>> variantConflicts();
   std::set<std::pair<manifest_idx_t, manifest_idx_t>> computeDependencies();
   std::set<std::set<manifest_idx_t>> computeCycles();
   std::map<llvm::Instruction *, std::set<manifest_idx_t>> computeExactCoverage(llvm::Module &M);
+  /**
+   * Approximates the coverage per basic block: every instruction of a block is covered by all manifests covering any
+   * part of it. Coverage groups, and with them the ILP columns, then follow the blocks instead of the instructions.
+   */
+  std::map<llvm::Instruction *, std::set<manifest_idx_t>> computeBlockCoverage(llvm::Module &M);
   std::set<std::set<manifest_idx_t>> computeConnectivity(const std::map<llvm::Instruction *, std::set<manifest_idx_t>> &mapping);
   std::set<std::set<manifest_idx_t>> computeBlockConnectivity(llvm::Module &M);
+  /**
+   * Finds the manifests whose hotness exceeds `-cf-hotness-limit` or the `-cf-hotness-percentile` of all block
+   * frequencies, together with the manifests undone with them
+   */
+  std::set<Manifest *> hotManifests(const std::unordered_map<llvm::BasicBlock *, uint64_t> &BFI);
+  std::map<manifest_idx_t, ManifestStats> computeManifestStats(const std::unordered_map<llvm::BasicBlock *,
+                                                                                        uint64_t> &BFI,
+                                                               std::pair<size_t, size_t> implicitCBounds,
+                                                               const metric::Weights &weights);
 
   /**
    * Detects and handles the conflicts in the graph `g`
@@ -201,7 +262,34 @@ public:
   std::set<Manifest *> randomConflictHandling(llvm::Module &M);
   std::set<Manifest *> ilpConflictHandling(llvm::Module &M,
                                            const std::unordered_map<llvm::BasicBlock *, uint64_t> &BFI,
-                                           size_t totalInstructions);
+                                           size_t totalInstructions,
+                                           const metric::Weights &weights);
+  std::set<Manifest *> greedyConflictHandling(llvm::Module &M,
+                                              const std::unordered_map<llvm::BasicBlock *, uint64_t> &BFI,
+                                              const metric::Weights &weights);
+  std::set<Manifest *> multiStartConflictHandling(llvm::Module &M,
+                                                  const std::unordered_map<llvm::BasicBlock *, uint64_t> &BFI,
+                                                  const metric::Weights &weights);
+  /**
+   * Solves the LP relaxation of the ILP model, rounds it and repairs the rounded selection with the greedy resolver
+   */
+  std::set<Manifest *> lpConflictHandling(llvm::Module &M,
+                                          const std::unordered_map<llvm::BasicBlock *, uint64_t> &BFI,
+                                          const metric::Weights &weights);
+
+  /**
+   * Improves the selection of a strategy by local search for `-cf-refine-time` seconds
+   * @param accepted the conflict free selection
+   * @return the refined selection
+   */
+  std::set<Manifest *> refineSelection(llvm::Module &M, const std::unordered_map<llvm::BasicBlock *, uint64_t> &BFI,
+                                       const metric::Weights &weights, const std::set<Manifest *> &accepted);
+
+  /**
+   * Builds the manifest level view of the graph the heuristic strategies resolve conflicts on
+   */
+  Greedy<manifest_idx_t> buildResolver(llvm::Module &M, const std::unordered_map<llvm::BasicBlock *, uint64_t> &BFI,
+                                       const metric::Weights &weights);
 
   template<typename Iter, typename RandomGenerator> Iter select_randomly(Iter start, Iter end, RandomGenerator &g) {
     std::uniform_int_distribution<> dis(0, std::distance(start, end) - 1);
@@ -0,0 +1,798 @@
+#ifndef COMPOSITION_GRAPH_ALGORITHM_GREEDY_HPP
+#define COMPOSITION_GRAPH_ALGORITHM_GREEDY_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <queue>
+#include <random>
+#include <set>
+#include <stack>
+#include <utility>
+#include <vector>
+
+namespace composition::graph::algorithm {
+
+/**
+ * Greedy conflict resolution on a manifest level view of the protection graph.
+ *
+ * Manifests are only ever dropped, never added back: every conflict and every cycle loses the member which is the
+ * cheapest to drop, i.e., whose undo cascade keeps the least coverage per cost, or a random member once randomized.
+ * Arcs of the protection graph are owned by the manifests whose constraints put them there and vanish together with
+ * their last owner, hence cycles are found with one SCC pass per round instead of rebuilding the graph. The overhead,
+ * explicit and implicit coverage bounds are honored on a best-effort basis: dropping never adds coverage back.
+ *
+ * A resolved selection can be improved by `refine`, a local search adding, dropping and swapping manifests. Explicit and
+ * implicit coverage, conflict and arc counters are updated incrementally with every move, a move is evaluated by
+ * applying and reverting it. Accepted manifests are checked for new cycles against a cached condensation of the graph,
+ * which only has to be recomputed when an accepted arc goes against its order.
+ *
+ * The view is a plain copyable value without references into the protection graph, copies may be resolved
+ * concurrently.
+ * @tparam Idx the manifest index type
+ */
+template<typename Idx> class Greedy {
+public:
+  struct Bounds {
+    double overhead{};
+    size_t explicitC{};
+    size_t implicitC{};
+  };
+
+  struct Result {
+    std::set<Idx> accepted{};
+    double overhead{};
+    size_t explicitC{};
+    size_t implicitC{};
+    size_t conflicts{};
+    size_t cycles{};
+    /**
+     * Moves applied by `refine`
+     */
+    size_t moves{};
+    bool boundsMet{};
+  };
+
+private:
+  struct Group {
+    std::vector<Idx> manifests{};
+    size_t weight{};
+    size_t active{};
+    /**
+     * Accepted members with an accepted protector
+     */
+    size_t guarded{};
+  };
+
+  size_t nodeCount{};
+  std::vector<std::pair<size_t, size_t>> arcs{};
+  /**
+   * Arcs without owners (hierarchy, shadow connections) are always active, owned ones while an owner is active
+   */
+  std::vector<bool> activeArcs{};
+  std::vector<size_t> activeOwners{};
+  std::vector<std::vector<Idx>> arcOwners{};
+  std::vector<std::vector<size_t>> outArcs{};
+  std::vector<std::vector<size_t>> inArcs{};
+
+  std::map<Idx, bool> active{};
+  std::map<Idx, double> costs{};
+  std::map<Idx, double> scores{};
+  std::map<Idx, std::set<Idx>> dependents{};
+  /**
+   * Inverse of `dependents`, a manifest can only be accepted while all of its prerequisites are
+   */
+  std::map<Idx, std::set<Idx>> prerequisites{};
+  std::map<Idx, std::set<Idx>> protectors{};
+  std::map<Idx, std::set<Idx>> protectees{};
+  /**
+   * Number of accepted protectors of each manifest
+   */
+  std::map<Idx, size_t> activeProtectors{};
+  std::map<Idx, std::vector<size_t>> ownedArcs{};
+  std::map<Idx, std::vector<size_t>> manifestGroups{};
+  std::vector<Group> groups{};
+  std::vector<std::pair<Idx, Idx>> conflicts{};
+  std::map<Idx, std::vector<Idx>> conflictPartners{};
+  /**
+   * Number of accepted conflict partners of each manifest
+   */
+  std::map<Idx, size_t> activePartners{};
+
+  double overhead{};
+  size_t explicitC{};
+  size_t implicitC{};
+  /**
+   * Weights of explicit and implicit coverage in the scores, the bounds are in instructions regardless
+   */
+  double explicitWeight{1.0};
+  double implicitWeight{0.0};
+  /**
+   * Component of each node in the condensation of a supergraph of the active arcs, numbered in reverse topological
+   * order. Dropping arcs keeps it valid, accepting an arc against the order invalidates it.
+   */
+  std::optional<std::vector<size_t>> condensation{};
+
+  std::optional<std::mt19937_64> rng{};
+
+  bool isActive(Idx m) const {
+    auto found = active.find(m);
+    return found != active.end() && found->second;
+  }
+
+  /**
+   * @return true if `m` and one of its protectors are accepted, i.e., if `m` adds to the implicit coverage
+   */
+  bool isGuarded(Idx m) const {
+    auto found = activeProtectors.find(m);
+    return isActive(m) && found != activeProtectors.end() && found->second > 0;
+  }
+
+  /**
+   * Updates the implicit coverage of the groups of `m` after it was guarded or not as given by `was`
+   */
+  void updateGuarded(Idx m, bool was) {
+    bool is = isGuarded(m);
+    if (is == was) {
+      return;
+    }
+    for (auto g : manifestGroups[m]) {
+      auto &group = groups[g];
+      if (is && group.guarded++ == 0) {
+        implicitC += group.weight;
+      } else if (!is && --group.guarded == 0) {
+        implicitC -= group.weight;
+      }
+    }
+  }
+
+  /**
+   * Updates the guarded state of `m` and of the manifests it protects after accepting or dropping it
+   */
+  void updateProtection(Idx m, bool value, bool was) {
+    updateGuarded(m, was);
+    for (auto q : protectees[m]) {
+      bool wasQ = isGuarded(q);
+      if (value) {
+        ++activeProtectors[q];
+      } else {
+        --activeProtectors[q];
+      }
+      updateGuarded(q, wasQ);
+    }
+  }
+
+  /**
+   * @return `m` and all active manifests which transitively depend on it, i.e., which are undone together with `m`
+   */
+  std::vector<Idx> cascade(Idx m) const {
+    std::vector<Idx> result{};
+    std::set<Idx> seen{};
+    std::stack<Idx> s{};
+    s.push(m);
+    while (!s.empty()) {
+      Idx current = s.top();
+      s.pop();
+      if (!isActive(current) || !seen.insert(current).second) {
+        continue;
+      }
+      result.push_back(current);
+      if (auto found = dependents.find(current); found != dependents.end()) {
+        for (auto d : found->second) {
+          s.push(d);
+        }
+      }
+    }
+    return result;
+  }
+
+  double dropPrice(Idx m) const {
+    double price = 0;
+    for (auto c : cascade(m)) {
+      price += scores.at(c);
+    }
+    return price;
+  }
+
+  Idx choose(const std::set<Idx> &ms) {
+    if (rng) {
+      std::uniform_int_distribution<size_t> dis(0, ms.size() - 1);
+      return *std::next(ms.begin(), static_cast<long>(dis(*rng)));
+    }
+
+    Idx best = *ms.begin();
+    double bestPrice = dropPrice(best);
+    for (auto m : ms) {
+      double price = dropPrice(m);
+      if (price < bestPrice) {
+        best = m;
+        bestPrice = price;
+      }
+    }
+    return best;
+  }
+
+  void setActive(const std::vector<Idx> &ms, bool value) {
+    for (auto m : ms) {
+      bool was = isGuarded(m);
+      active[m] = value;
+      updateProtection(m, value, was);
+      overhead += value ? costs[m] : -costs[m];
+      for (auto p : conflictPartners[m]) {
+        if (value) {
+          ++activePartners[p];
+        } else {
+          --activePartners[p];
+        }
+      }
+      for (auto g : manifestGroups[m]) {
+        auto &group = groups[g];
+        if (value && group.active++ == 0) {
+          explicitC += group.weight;
+        } else if (!value && --group.active == 0) {
+          explicitC -= group.weight;
+        }
+      }
+      for (auto a : ownedArcs[m]) {
+        if (value) {
+          ++activeOwners[a];
+        } else {
+          --activeOwners[a];
+        }
+        activeArcs[a] = activeOwners[a] > 0;
+      }
+    }
+  }
+
+  std::vector<Idx> drop(Idx m) {
+    auto removed = cascade(m);
+    setActive(removed, false);
+    return removed;
+  }
+
+  bool withinCoverageBounds(const Bounds &bounds) const {
+    return explicitC >= bounds.explicitC && (bounds.implicitC == 0 || implicitC >= bounds.implicitC);
+  }
+
+  /**
+   * Strongly connected components of the active arcs (iterative Tarjan)
+   * @return the component of each node
+   */
+  std::vector<size_t> components() const {
+    std::vector<std::vector<size_t>> out(nodeCount);
+    for (size_t a = 0; a < arcs.size(); ++a) {
+      if (activeArcs[a]) {
+        out[arcs[a].first].push_back(arcs[a].second);
+      }
+    }
+
+    const size_t unvisited = SIZE_MAX;
+    std::vector<size_t> index(nodeCount, unvisited);
+    std::vector<size_t> low(nodeCount, 0);
+    std::vector<size_t> component(nodeCount, unvisited);
+    std::vector<bool> onStack(nodeCount, false);
+    std::vector<size_t> stack{};
+    // node and position of the next out arc to follow
+    std::vector<std::pair<size_t, size_t>> calls{};
+    size_t counter = 0;
+    size_t componentCount = 0;
+
+    auto visit = [&](size_t v) {
+      index[v] = low[v] = counter++;
+      stack.push_back(v);
+      onStack[v] = true;
+      calls.emplace_back(v, 0);
+    };
+
+    for (size_t root = 0; root < nodeCount; ++root) {
+      if (index[root] != unvisited) {
+        continue;
+      }
+      visit(root);
+      while (!calls.empty()) {
+        size_t v = calls.back().first;
+        if (calls.back().second < out[v].size()) {
+          size_t w = out[v][calls.back().second++];
+          if (index[w] == unvisited) {
+            visit(w);
+          } else if (onStack[w]) {
+            low[v] = std::min(low[v], index[w]);
+          }
+          continue;
+        }
+
+        calls.pop_back();
+        if (!calls.empty()) {
+          size_t parent = calls.back().first;
+          low[parent] = std::min(low[parent], low[v]);
+        }
+        if (low[v] == index[v]) {
+          size_t w;
+          do {
+            w = stack.back();
+            stack.pop_back();
+            onStack[w] = false;
+            component[w] = componentCount;
+          } while (w != v);
+          ++componentCount;
+        }
+      }
+    }
+    return component;
+  }
+
+  size_t resolveConflicts() {
+    auto order = conflicts;
+    if (rng) {
+      std::shuffle(order.begin(), order.end(), *rng);
+    }
+
+    size_t resolved = 0;
+    for (auto &[m1, m2] : order) {
+      if (!isActive(m1) || !isActive(m2)) {
+        continue;
+      }
+      drop(choose({m1, m2}));
+      ++resolved;
+    }
+    return resolved;
+  }
+
+  size_t breakCycles() {
+    size_t broken = 0;
+    bool changed;
+    do {
+      changed = false;
+      auto component = components();
+
+      // Owners of the arcs inside each component, components built by a single manifest are not a conflict
+      std::map<size_t, std::set<Idx>> owners{};
+      for (size_t a = 0; a < arcs.size(); ++a) {
+        auto[source, target] = arcs[a];
+        if (!activeArcs[a] || component[source] != component[target]) {
+          continue;
+        }
+        for (auto m : arcOwners[a]) {
+          if (isActive(m)) {
+            owners[component[source]].insert(m);
+          }
+        }
+      }
+
+      for (auto &[_, ms] : owners) {
+        // A drop for an earlier component may already have cascaded into this one
+        std::set<Idx> live{};
+        for (auto m : ms) {
+          if (isActive(m)) {
+            live.insert(m);
+          }
+        }
+        if (live.size() < 2) {
+          continue;
+        }
+        drop(choose(live));
+        ++broken;
+        changed = true;
+      }
+    } while (changed);
+    return broken;
+  }
+
+  void trimOverhead(const Bounds &bounds) {
+    using entry_t = std::pair<double, Idx>;
+    std::priority_queue<entry_t, std::vector<entry_t>, std::greater<entry_t>> candidates{};
+    for (auto &[m, isOn] : active) {
+      if (isOn) {
+        candidates.push({scores[m], m});
+      }
+    }
+
+    while (overhead > bounds.overhead && !candidates.empty()) {
+      Idx m = candidates.top().second;
+      candidates.pop();
+      if (!isActive(m)) {
+        continue;
+      }
+      auto removed = drop(m);
+      if (!withinCoverageBounds(bounds)) {
+        // Keep the coverage bounds intact, the overhead bound is the one given up
+        setActive(removed, true);
+      }
+    }
+  }
+
+  /**
+   * Nodes reachable from `start` over the active arcs, following `adjacent` arcs from `forward` endpoints
+   */
+  std::vector<bool> reachable(size_t start, const std::vector<std::vector<size_t>> &adjacent, bool forward) const {
+    std::vector<bool> seen(nodeCount, false);
+    std::stack<size_t> s{};
+    s.push(start);
+    seen[start] = true;
+    while (!s.empty()) {
+      size_t v = s.top();
+      s.pop();
+      for (auto a : adjacent[v]) {
+        size_t w = forward ? arcs[a].second : arcs[a].first;
+        if (activeArcs[a] && !seen[w]) {
+          seen[w] = true;
+          s.push(w);
+        }
+      }
+    }
+    return seen;
+  }
+
+  /**
+   * Checks against the cached condensation if every arc of `m` goes forward in its topological order. Such arcs cannot
+   * close a cycle: all other active arcs go forward too or stay inside a component.
+   */
+  bool forward(Idx m) {
+    if (!condensation) {
+      condensation = components();
+    }
+    auto found = ownedArcs.find(m);
+    if (found == ownedArcs.end()) {
+      return true;
+    }
+    auto &component = *condensation;
+    return std::all_of(found->second.begin(), found->second.end(), [&](size_t a) {
+      return component[arcs[a].first] > component[arcs[a].second];
+    });
+  }
+
+  /**
+   * Checks if an arc of the accepted manifest `m` is on a cycle with an arc of another accepted manifest, i.e., if
+   * accepting `m` closed a cycle `breakCycles` would have to break. Each arc of `m` costs a forward and a backward
+   * search over the active arcs, callers check `forward` first.
+   */
+  bool closesCycle(Idx m) const {
+    auto found = ownedArcs.find(m);
+    if (found == ownedArcs.end()) {
+      return false;
+    }
+    for (auto a : found->second) {
+      // Arc u -> v is on a cycle through s -> t iff t reaches u and v reaches s
+      auto[source, target] = arcs[a];
+      auto fromTarget = reachable(target, outArcs, true);
+      if (!fromTarget[source]) {
+        continue;
+      }
+      auto toSource = reachable(source, inArcs, false);
+      for (size_t other = 0; other < arcs.size(); ++other) {
+        if (!activeArcs[other] || !fromTarget[arcs[other].first] || !toSource[arcs[other].second]) {
+          continue;
+        }
+        for (auto owner : arcOwners[other]) {
+          if (owner != m && isActive(owner)) {
+            return true;
+          }
+        }
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Refinement objective: overhead above its bound first, then explicit coverage, then overhead
+   */
+  struct Score {
+    double excess;
+    size_t explicitC;
+    double overhead;
+
+    bool operator>(const Score &other) const {
+      constexpr double epsilon = 1e-9;
+      if (std::abs(excess - other.excess) > epsilon) {
+        return excess < other.excess;
+      }
+      if (explicitC != other.explicitC) {
+        return explicitC > other.explicitC;
+      }
+      return overhead < other.overhead - epsilon;
+    }
+  };
+
+  Score score(const Bounds &bounds) const {
+    return {bounds.overhead > 0 ? std::max(0.0, overhead - bounds.overhead) : 0.0, explicitC, overhead};
+  }
+
+  /**
+   * A move may not break a coverage bound the selection met before
+   */
+  bool keepsBounds(const Bounds &bounds, bool explicitMet, bool implicitMet) const {
+    if (explicitMet && explicitC < bounds.explicitC) {
+      return false;
+    }
+    return !implicitMet || bounds.implicitC == 0 || implicitC >= bounds.implicitC;
+  }
+
+  bool canAccept(Idx m) const {
+    if (isActive(m)) {
+      return false;
+    }
+    if (auto found = prerequisites.find(m); found != prerequisites.end()) {
+      for (auto p : found->second) {
+        if (!isActive(p)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Applies the move which drops the cascades of `drops` and accepts `add` if it improves the selection
+   * @return true if the move was applied
+   */
+  bool tryMove(const std::vector<Idx> &drops, std::optional<Idx> add, const Bounds &bounds) {
+    auto before = score(bounds);
+    bool explicitMet = explicitC >= bounds.explicitC;
+    bool implicitMet = bounds.implicitC == 0 || implicitC >= bounds.implicitC;
+    // The condensation has to cover the arcs of the drops, they come back if the move is reverted
+    bool ordered = !add || forward(*add);
+
+    std::vector<Idx> removed{};
+    for (auto d : drops) {
+      if (isActive(d)) {
+        auto cascaded = drop(d);
+        removed.insert(removed.end(), cascaded.begin(), cascaded.end());
+      }
+    }
+    bool added = false;
+    bool feasible = true;
+    if (add) {
+      feasible = canAccept(*add) && activePartners[*add] == 0;
+      if (feasible) {
+        setActive({*add}, true);
+        added = true;
+        feasible = ordered || !closesCycle(*add);
+      }
+    }
+
+    if (feasible && score(bounds) > before && keepsBounds(bounds, explicitMet, implicitMet)) {
+      if (!ordered) {
+        condensation.reset();
+      }
+      return true;
+    }
+    if (added) {
+      setActive({*add}, false);
+    }
+    setActive(removed, true);
+    return false;
+  }
+
+  Result collect(const Bounds &bounds) const {
+    Result result{};
+    for (auto &[m, isOn] : active) {
+      if (isOn) {
+        result.accepted.insert(m);
+      }
+    }
+    result.overhead = overhead;
+    result.explicitC = explicitC;
+    result.implicitC = implicitC;
+    result.boundsMet = result.explicitC >= bounds.explicitC && result.implicitC >= bounds.implicitC &&
+        (bounds.overhead <= 0 || result.overhead <= bounds.overhead);
+    return result;
+  }
+
+public:
+  /**
+   * Resolves by dropping random members instead of the cheapest ones, a given seed always yields the same result
+   */
+  void randomize(uint64_t seed) { rng.emplace(seed); }
+
+  /**
+   * Adds a manifest, all manifests start accepted
+   * @param m the manifest
+   * @param cost the cost of keeping the manifest, as used by the ILP objective
+   */
+  void addManifest(Idx m, double cost) {
+    bool was = isGuarded(m);
+    active[m] = true;
+    updateProtection(m, true, was);
+    condensation.reset();
+    costs[m] = cost;
+    overhead += cost;
+    for (auto p : conflictPartners[m]) {
+      ++activePartners[p];
+    }
+  }
+
+  /**
+   * `dependent` is undone whenever `m` is undone
+   */
+  void addDependent(Idx m, Idx dependent) {
+    dependents[m].insert(dependent);
+    prerequisites[dependent].insert(m);
+  }
+
+  /**
+   * `protector` covers the guard of `protectee`, i.e., the coverage of `protectee` is implicitly protected by
+   * `protector`
+   */
+  void addProtection(Idx protectee, Idx protector) {
+    if (!protectors[protectee].insert(protector).second) {
+      return;
+    }
+    protectees[protector].insert(protectee);
+    if (isActive(protector)) {
+      bool was = isGuarded(protectee);
+      ++activeProtectors[protectee];
+      updateGuarded(protectee, was);
+    }
+  }
+
+  void addConflict(Idx m1, Idx m2) {
+    conflicts.emplace_back(m1, m2);
+    conflictPartners[m1].push_back(m2);
+    conflictPartners[m2].push_back(m1);
+    if (isActive(m1)) {
+      ++activePartners[m2];
+    }
+    if (isActive(m2)) {
+      ++activePartners[m1];
+    }
+  }
+
+  /**
+   * Drops `m` and its dependents before resolving, e.g., to start from a rounded LP relaxation
+   */
+  void exclude(Idx m) { drop(m); }
+
+  /**
+   * Adds an arc between the nodes `source` and `target`, the arc stays active until it is given owners
+   * @return the index of the arc
+   */
+  size_t addArc(size_t source, size_t target) {
+    nodeCount = std::max(nodeCount, std::max(source, target) + 1);
+    outArcs.resize(nodeCount);
+    inArcs.resize(nodeCount);
+    outArcs[source].push_back(arcs.size());
+    inArcs[target].push_back(arcs.size());
+    arcs.emplace_back(source, target);
+    activeArcs.push_back(true);
+    activeOwners.push_back(0);
+    arcOwners.emplace_back();
+    condensation.reset();
+    return arcs.size() - 1;
+  }
+
+  /**
+   * Marks `m` as an owner of the arc `a`, the arc is removed together with its last owner
+   */
+  void addArcOwner(size_t a, Idx m) {
+    arcOwners[a].push_back(m);
+    ownedArcs[m].push_back(a);
+    if (isActive(m)) {
+      ++activeOwners[a];
+    }
+    activeArcs[a] = activeOwners[a] > 0;
+    condensation.reset();
+  }
+
+  /**
+   * Weighs explicit and implicit coverage in the drop order, e.g. by `Weights::explicitInstructionCoverage` and
+   * `Weights::implicitInstructionCoverage`. Only explicit coverage counts by default.
+   */
+  void setCoverageWeights(double explicitW, double implicitW) {
+    explicitWeight = explicitW;
+    implicitWeight = implicitW;
+  }
+
+  /**
+   * Adds `weight` instructions which are explicitly covered by each manifest in `ms`
+   */
+  void addCoverage(const std::set<Idx> &ms, size_t weight) {
+    size_t g = groups.size();
+    groups.push_back(Group{{ms.begin(), ms.end()}, weight, 0, 0});
+    for (auto m : ms) {
+      manifestGroups[m].push_back(g);
+      if (isActive(m)) {
+        ++groups[g].active;
+      }
+      if (isGuarded(m)) {
+        ++groups[g].guarded;
+      }
+    }
+    if (groups[g].active > 0) {
+      explicitC += weight;
+    }
+    if (groups[g].guarded > 0) {
+      implicitC += weight;
+    }
+  }
+
+  Result run(const Bounds &bounds) {
+    // Score: weighted coverage share per cost, instructions covered by several manifests are split between them and
+    // implicit coverage between the protectors of a manifest
+    auto groupShare = [this](Idx m) {
+      double share = 0;
+      for (auto g : manifestGroups[m]) {
+        share += static_cast<double>(groups[g].weight) / static_cast<double>(groups[g].manifests.size());
+      }
+      return share;
+    };
+    for (auto &[m, _] : active) {
+      double implicitShare = 0;
+      for (auto q : protectees[m]) {
+        implicitShare += groupShare(q) / static_cast<double>(protectors[q].size());
+      }
+      scores[m] = (1.0 + explicitWeight * groupShare(m) + implicitWeight * implicitShare) / (1.0 + costs[m]);
+    }
+
+    auto conflictCount = resolveConflicts();
+    auto cycleCount = breakCycles();
+    if (bounds.overhead > 0 && overhead > bounds.overhead) {
+      trimOverhead(bounds);
+    }
+
+    auto result = collect(bounds);
+    result.conflicts = conflictCount;
+    result.cycles = cycleCount;
+    return result;
+  }
+
+  /**
+   * Improves the current selection, which has to be free of conflicts and cycles, e.g. after `run` or after excluding
+   * the manifests another strategy rejected. Every accepted manifest is tried to be dropped, every rejected one to be
+   * accepted, and, if it conflicts, to be swapped with its accepted conflict partners. A move is applied if it lowers
+   * the overhead above `bounds.overhead`, adds explicit coverage, or keeps the coverage at a lower overhead, and does
+   * not break a coverage bound met before. Passes repeat until no move applies or `seconds` ran out.
+   * @param bounds the bounds of the selection
+   * @param seconds the time budget
+   */
+  Result refine(const Bounds &bounds, double seconds) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(seconds));
+    std::vector<Idx> order{};
+    for (auto &[m, _] : active) {
+      order.push_back(m);
+    }
+
+    size_t moves = 0;
+    bool improved = true;
+    while (improved && std::chrono::steady_clock::now() < deadline) {
+      improved = false;
+      if (rng) {
+        std::shuffle(order.begin(), order.end(), *rng);
+      }
+      for (auto m : order) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+          break;
+        }
+        bool applied;
+        if (isActive(m)) {
+          applied = tryMove({m}, std::nullopt, bounds);
+        } else if (activePartners[m] == 0) {
+          applied = tryMove({}, m, bounds);
+        } else {
+          std::vector<Idx> partners{};
+          for (auto p : conflictPartners[m]) {
+            if (isActive(p)) {
+              partners.push_back(p);
+            }
+          }
+          applied = tryMove(partners, m, bounds);
+        }
+        if (applied) {
+          ++moves;
+          improved = true;
+        }
+      }
+    }
+
+    auto result = collect(bounds);
+    result.moves = moves;
+    return result;
+  }
+};
+} // namespace composition::graph::algorithm
+#endif // COMPOSITION_GRAPH_ALGORITHM_GREEDY_HPP
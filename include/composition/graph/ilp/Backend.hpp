@@ -0,0 +1,147 @@
+#ifndef COMPOSITION_GRAPH_ILP_BACKEND_HPP
+#define COMPOSITION_GRAPH_ILP_BACKEND_HPP
+
+#include <atomic>
+#include <composition/graph/ilp/Model.hpp>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace composition::graph::ilp {
+/**
+ * Result of a solver run
+ */
+enum class Status { Optimal, Feasible, Infeasible, Unbounded, Undefined };
+
+/**
+ * Branching technique used by branch-and-bound. Backends without a matching technique use their default.
+ */
+enum class Branching { FirstFractional, LastFractional, MostFractional, DriebeckTomlin, PseudoCost };
+
+/**
+ * Backtracking technique used by branch-and-bound. Backends without a matching technique use their default.
+ */
+enum class Backtracking { DepthFirst, BreadthFirst, BestLocalBound, BestProjection };
+
+/**
+ * Algorithm used to solve an LP relaxation
+ */
+enum class LPMethod { Simplex, Interior };
+
+/**
+ * Parameters which control a solver run
+ */
+struct Parameters {
+  bool presolve = true;
+  bool cuts = true;
+  Branching branching = Branching::PseudoCost;
+  Backtracking backtracking = Backtracking::BestLocalBound;
+  /**
+   * Time limit in seconds, 0 disables the limit
+   */
+  double timeLimit = 0;
+  /**
+   * Solves only the LP relaxation, the integrality of the columns is ignored
+   */
+  bool relaxation = false;
+  LPMethod lpMethod = LPMethod::Simplex;
+  /**
+   * Stops branch-and-bound early once set, e.g., by a concurrent run. Backends without support ignore it.
+   */
+  std::atomic<bool> *cancel = nullptr;
+  /**
+   * Called with the column values, indexed by the column - 1, and the objective value of every improved integer
+   * solution branch-and-bound finds. Backends without support ignore it.
+   */
+  std::function<void(const std::vector<double> &, double)> onIncumbent{};
+  /**
+   * Column values, indexed by the column - 1, of a feasible solution to start branch-and-bound from. Backends without
+   * support ignore it.
+   */
+  const std::vector<double> *warmStart = nullptr;
+  /**
+   * Silences the solver and the backend, e.g., for runs on other threads. The outcome is kept for `summary`.
+   */
+  bool quiet = false;
+};
+
+/**
+ * Interface of a mixed integer programming solver
+ */
+class Backend {
+public:
+  virtual ~Backend() = default;
+
+  /**
+   * @return the name of the backend as used by `-cf-ilp-backend`
+   */
+  virtual std::string name() const = 0;
+
+  /**
+   * Loads the model into the solver. Replaces any previously loaded model.
+   * @param model the model
+   */
+  virtual void load(const Model &model) = 0;
+
+  /**
+   * Solves the loaded model. The values reported afterwards belong to the solution of this run, i.e., to the LP
+   * relaxation if `params.relaxation` is set.
+   * @param params the parameters of the run
+   * @return the status of the solution
+   */
+  virtual Status solve(const Parameters &params) = 0;
+
+  /**
+   * Changes the bounds of a row of the loaded model. A following `solve` without presolving starts from the previous
+   * basis.
+   */
+  virtual void setRowBounds(int row, BoundType type, double lb, double ub) = 0;
+
+  virtual double objectiveValue() const = 0;
+  virtual double columnValue(int col) const = 0;
+  virtual double rowValue(int row) const = 0;
+
+  /**
+   * Writes the loaded problem to `file`
+   */
+  virtual void writeProblem(const std::string &file) = 0;
+
+  /**
+   * Writes the machine readable solution to `file`
+   */
+  virtual void writeSolution(const std::string &file) = 0;
+
+  /**
+   * Writes the human readable solution to `file`
+   */
+  virtual void writeReadableSolution(const std::string &file) = 0;
+
+  /**
+   * Reads a solution written by `writeSolution` of the same model, e.g., by another instance of the backend
+   * @return true if the solution was read
+   */
+  virtual bool readSolution(const std::string &file) = 0;
+
+  /**
+   * @return how the last solve ended, e.g., the exit and status codes of the solver
+   */
+  virtual std::string summary() const = 0;
+};
+
+/**
+ * Creates the backend with the given name
+ * @param name the name of the backend, e.g. "glpk"
+ * @return the backend
+ */
+std::unique_ptr<Backend> createBackend(const std::string &name);
+
+const char *toString(Status status);
+
+/**
+ * @return a short description of the branch-and-bound settings of `params` for logging
+ */
+std::string describe(const Parameters &params);
+} // namespace composition::graph::ilp
+
+#endif // COMPOSITION_GRAPH_ILP_BACKEND_HPP
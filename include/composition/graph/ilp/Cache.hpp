@@ -0,0 +1,35 @@
+#ifndef COMPOSITION_GRAPH_ILP_CACHE_HPP
+#define COMPOSITION_GRAPH_ILP_CACHE_HPP
+
+#include <composition/graph/ilp/Model.hpp>
+#include <optional>
+#include <set>
+#include <string>
+
+namespace composition::graph::ilp {
+/**
+ * On-disk cache of solved models. An entry is keyed by a hash over the canonical form of the model, which does not
+ * depend on the order rows and columns were added in, and over the solver configuration. It stores the names of the
+ * columns set in the optimal solution.
+ */
+class Cache {
+private:
+  std::string directory;
+
+  std::string path(const std::string &key) const;
+
+public:
+  explicit Cache(std::string directory);
+
+  /**
+   * @param configuration everything besides the model which influences the solution, e.g., backend and parameters
+   */
+  static std::string key(const Model &model, const std::string &configuration);
+
+  std::optional<std::set<std::string>> lookup(const std::string &key) const;
+
+  void store(const std::string &key, const std::set<std::string> &columns) const;
+};
+} // namespace composition::graph::ilp
+
+#endif // COMPOSITION_GRAPH_ILP_CACHE_HPP
@@ -0,0 +1,52 @@
+#ifndef COMPOSITION_GRAPH_ILP_CHECKPOINT_HPP
+#define COMPOSITION_GRAPH_ILP_CHECKPOINT_HPP
+
+#include <composition/graph/ilp/Model.hpp>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace composition::graph::ilp {
+/**
+ * File holding the best integer solution found so far for a model. It is rewritten with every improved incumbent, such
+ * that a killed solve can be resumed from it. The file belongs to the model with the same key (see `Cache::key`),
+ * solutions of other models are ignored.
+ */
+class Checkpoint {
+private:
+  std::string file;
+  std::string key;
+  Direction direction;
+  std::mutex mutex{};
+  std::optional<double> best{};
+
+public:
+  struct Entry {
+    double objective{};
+    /**
+     * Value of each column, indexed by the column - 1
+     */
+    std::vector<double> values{};
+  };
+
+  Checkpoint(std::string file, std::string key, Direction direction);
+
+  /**
+   * @return the saved solution if it belongs to `model`
+   */
+  std::optional<Entry> load(const Model &model);
+
+  /**
+   * Saves a solution of `model` unless an equal or better one was saved before. May be called concurrently.
+   * @param values the value of each column, indexed by the column - 1
+   * @param objective the objective value
+   * @param manifests the indices of the accepted manifests, saved for inspection only
+   */
+  void store(const Model &model, const std::vector<double> &values, double objective,
+             const std::vector<uint64_t> &manifests);
+};
+} // namespace composition::graph::ilp
+
+#endif // COMPOSITION_GRAPH_ILP_CHECKPOINT_HPP
@@ -0,0 +1,62 @@
+#ifndef COMPOSITION_GRAPH_ILP_GLPKBACKEND_HPP
+#define COMPOSITION_GRAPH_ILP_GLPKBACKEND_HPP
+
+#include <composition/graph/ilp/Backend.hpp>
+#include <glpk.h>
+
+namespace composition::graph::ilp {
+/**
+ * Backend using the GNU Linear Programming Kit
+ */
+class GLPKBackend : public Backend {
+private:
+  glp_prob *lp;
+  /**
+   * GLPK keeps the simplex, interior point and MIP solutions apart, the values are read from the last one computed
+   */
+  enum class Solution { MIP, Simplex, Interior };
+  Solution solution = Solution::MIP;
+  /**
+   * Outcome of the last solve and whether it was quiet, a quiet solve also writes its solution quietly
+   */
+  std::string outcome{};
+  bool quiet = false;
+
+  /**
+   * Keeps `message` as the outcome and logs it unless the solve is quiet
+   */
+  void report(const std::string &message);
+
+  Status solveRelaxation(const Parameters &params);
+
+public:
+  GLPKBackend();
+
+  ~GLPKBackend() override;
+
+  GLPKBackend(GLPKBackend const &) = delete;
+
+  GLPKBackend &operator=(GLPKBackend const &) = delete;
+
+  std::string name() const override { return "glpk"; }
+
+  void load(const Model &model) override;
+
+  Status solve(const Parameters &params) override;
+
+  void setRowBounds(int row, BoundType type, double lb, double ub) override;
+
+  double objectiveValue() const override;
+  double columnValue(int col) const override;
+  double rowValue(int row) const override;
+
+  void writeProblem(const std::string &file) override;
+  void writeSolution(const std::string &file) override;
+  void writeReadableSolution(const std::string &file) override;
+  bool readSolution(const std::string &file) override;
+
+  std::string summary() const override { return outcome; }
+};
+} // namespace composition::graph::ilp
+
+#endif // COMPOSITION_GRAPH_ILP_GLPKBACKEND_HPP
@@ -0,0 +1,43 @@
+#ifndef COMPOSITION_GRAPH_ILP_HIGHSBACKEND_HPP
+#define COMPOSITION_GRAPH_ILP_HIGHSBACKEND_HPP
+
+#ifdef COMPOSITION_HAVE_HIGHS
+#include <Highs.h>
+#include <composition/graph/ilp/Backend.hpp>
+
+namespace composition::graph::ilp {
+/**
+ * Backend using the HiGHS solver. Only available if the framework was configured with
+ * `-DCompositionFramework_UseHiGHS=ON`.
+ */
+class HiGHSBackend : public Backend {
+private:
+  Highs highs{};
+  std::string outcome{};
+
+public:
+  HiGHSBackend();
+
+  std::string name() const override { return "highs"; }
+
+  void load(const Model &model) override;
+
+  Status solve(const Parameters &params) override;
+
+  void setRowBounds(int row, BoundType type, double lb, double ub) override;
+
+  double objectiveValue() const override;
+  double columnValue(int col) const override;
+  double rowValue(int row) const override;
+
+  void writeProblem(const std::string &file) override;
+  void writeSolution(const std::string &file) override;
+  void writeReadableSolution(const std::string &file) override;
+  bool readSolution(const std::string &file) override;
+
+  std::string summary() const override { return outcome; }
+};
+} // namespace composition::graph::ilp
+
+#endif // COMPOSITION_HAVE_HIGHS
+#endif // COMPOSITION_GRAPH_ILP_HIGHSBACKEND_HPP
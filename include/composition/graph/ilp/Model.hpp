@@ -0,0 +1,81 @@
+#ifndef COMPOSITION_GRAPH_ILP_MODEL_HPP
+#define COMPOSITION_GRAPH_ILP_MODEL_HPP
+
+#include <string>
+#include <vector>
+
+namespace composition::graph::ilp {
+/**
+ * Type of the bounds of a row or column
+ */
+enum class BoundType { Free, Lower, Upper, Double, Fixed };
+
+/**
+ * Kind of the values a column may take
+ */
+enum class ColumnKind { Continuous, Integer, Binary };
+
+/**
+ * Direction of the objective function
+ */
+enum class Direction { Minimize, Maximize };
+
+struct Row {
+  std::string name{};
+  BoundType type = BoundType::Free;
+  double lb{};
+  double ub{};
+};
+
+struct Column {
+  std::string name{};
+  ColumnKind kind = ColumnKind::Continuous;
+  BoundType type = BoundType::Lower;
+  double lb{};
+  double ub{};
+  double objective{};
+};
+
+/**
+ * Solver independent representation of a mixed integer program. Rows and columns are indexed starting at 1 such that
+ * indices can be handed to the backends unchanged.
+ */
+class Model {
+public:
+  Direction direction = Direction::Minimize;
+  std::vector<Row> rows{};
+  std::vector<Column> columns{};
+  /**
+   * The constraint matrix in coordinate format
+   */
+  std::vector<int> matrixRows{};
+  std::vector<int> matrixCols{};
+  std::vector<double> matrixCoeffs{};
+
+  int addRow();
+  int addColumn();
+
+  void setRowName(int row, const std::string &name);
+  void setRowBounds(int row, BoundType type, double lb, double ub);
+
+  void setColumnName(int col, const std::string &name);
+  void setColumnKind(int col, ColumnKind kind);
+  void setColumnBounds(int col, BoundType type, double lb, double ub);
+  void setObjective(int col, double coefficient);
+
+  const std::string &rowName(int row) const;
+  const std::string &columnName(int col) const;
+
+  /**
+   * Adds the coefficient `value` at position (`row`, `col`) of the constraint matrix. Each position may only be set
+   * once.
+   */
+  void addCoefficient(int row, int col, double value);
+
+  int numRows() const { return static_cast<int>(rows.size()); }
+  int numColumns() const { return static_cast<int>(columns.size()); }
+  size_t numCoefficients() const { return matrixCoeffs.size(); }
+};
+} // namespace composition::graph::ilp
+
+#endif // COMPOSITION_GRAPH_ILP_MODEL_HPP
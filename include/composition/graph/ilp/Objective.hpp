@@ -0,0 +1,304 @@
+#ifndef COMPOSITION_GRAPH_ILP_OBJECTIVE_HPP
+#define COMPOSITION_GRAPH_ILP_OBJECTIVE_HPP
+
+#include <composition/graph/ilp/Model.hpp>
+#include <composition/metric/Weights.hpp>
+#include <cstddef>
+#include <llvm/Support/raw_ostream.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace composition::graph::ilp {
+/**
+ * Quantities an objective can keep a bound row for. The optimized quantity has no row.
+ */
+enum BoundRow : unsigned {
+  ExplicitRow = 1u << 0u,
+  ImplicitRow = 1u << 1u,
+  OverheadRow = 1u << 2u,
+  ManifestRow = 1u << 3u
+};
+
+/**
+ * Bound rows of the model, 0 if the objective has no such row
+ */
+struct ObjectiveRows {
+  int explicitC{};
+  int implicitC{};
+  int overhead{};
+  int manifest{};
+};
+
+/**
+ * Bounds requested for the rows
+ */
+struct ObjectiveBounds {
+  double overhead{};
+  int explicitC{};
+  int implicitC{};
+};
+
+/**
+ * Contribution of a column to the bound rows
+ */
+struct ColumnValues {
+  double overhead{};
+  double explicitC{};
+  double implicitC{};
+  double manifest{};
+};
+
+/**
+ * What a column stands for, decides its objective coefficient
+ */
+enum class ColumnRole { Other, Manifest, Explicit, Implicit, Connectivity };
+
+/**
+ * A column of the model as seen by the objective, collected while the model is built
+ */
+struct ColumnTerm {
+  int col{};
+  ColumnRole role{ColumnRole::Other};
+  /**
+   * Cost and code size of a manifest
+   */
+  double overhead{};
+  size_t codeSize{};
+  /**
+   * Instructions of a coverage column
+   */
+  size_t coverage{};
+  /**
+   * True if the column contributes to the bound rows, as given by `values`
+   */
+  bool bounded{};
+  ColumnValues values{};
+};
+
+/**
+ * Objective of the ILP, implemented by `ObjectiveModule`. The per-column work happens in one call to `addColumns`.
+ */
+class Objective {
+public:
+  virtual ~Objective() = default;
+
+  /**
+   * @return the name of the objective as used by `-cf-ilp-obj`
+   */
+  virtual std::string name() const = 0;
+
+  virtual Direction direction() const = 0;
+
+  /**
+   * Adds the bound rows the objective keeps
+   */
+  virtual ObjectiveRows addRows(Model &model, const ObjectiveBounds &bounds) const = 0;
+
+  /**
+   * Sets the objective coefficient of each term and adds its coefficients to the bound rows. Terms with a column of 0
+   * are skipped.
+   */
+  virtual void addColumns(Model &model, const ObjectiveRows &rows, const std::vector<ColumnTerm> &terms,
+                          const metric::Weights &weights) const = 0;
+
+  /**
+   * @return true if the model needs the connectivity columns of the coverage groups
+   */
+  virtual bool needsConnectivity() const = 0;
+
+  /**
+   * Prints the results only this objective has, e.g. its optimized quantity
+   * @param objective the objective value of the solution
+   * @param explicitC the explicit coverage of the solution
+   */
+  virtual void report(llvm::raw_ostream &os, double objective, double explicitC) const = 0;
+
+  /**
+   * Short description of the objective for the result output
+   */
+  virtual const char *label() const = 0;
+};
+
+/**
+ * Defaults of an objective policy. A policy derives from it and shadows what it optimizes: `Name`, `Label`, `Dir`,
+ * the `Rows` it bounds, the coefficients and `report`.
+ */
+struct ObjectivePolicy {
+  static constexpr unsigned Rows = ExplicitRow | ImplicitRow | OverheadRow | ManifestRow;
+  static constexpr bool Connectivity = false;
+
+  static double manifest(double, size_t, const metric::Weights &) { return 0; }
+  static double explicitC(size_t, const metric::Weights &) { return 0; }
+  static double implicitC(size_t, const metric::Weights &) { return 0; }
+  static double connectivity(size_t, const metric::Weights &) { return 0; }
+  static void report(llvm::raw_ostream &, double, double) {}
+};
+
+struct MinOverhead : ObjectivePolicy {
+  static constexpr const char *Name = "overhead";
+  static constexpr const char *Label = "min Overhead. ";
+  static constexpr Direction Dir = Direction::Minimize;
+  static constexpr unsigned Rows = ExplicitRow | ImplicitRow | ManifestRow;
+
+  static double manifest(double overhead, size_t, const metric::Weights &) { return overhead; }
+};
+
+struct MaxExplicit : ObjectivePolicy {
+  static constexpr const char *Name = "explicit";
+  static constexpr const char *Label = "max Explicit. ";
+  static constexpr Direction Dir = Direction::Maximize;
+  static constexpr unsigned Rows = ImplicitRow | OverheadRow | ManifestRow;
+
+  static double explicitC(size_t coverage, const metric::Weights &w) {
+    return w.explicitInstructionCoverage * coverage;
+  }
+};
+
+struct MaxImplicit : ObjectivePolicy {
+  static constexpr const char *Name = "implicit";
+  static constexpr const char *Label = "max Implicit. ";
+  static constexpr Direction Dir = Direction::Maximize;
+  static constexpr unsigned Rows = ExplicitRow | OverheadRow | ManifestRow;
+
+  static double implicitC(size_t coverage, const metric::Weights &w) {
+    return w.implicitInstructionCoverage * coverage;
+  }
+};
+
+struct MaxConnectivity : ObjectivePolicy {
+  static constexpr const char *Name = "connectivity";
+  static constexpr const char *Label = "max Connectivity. ";
+  static constexpr Direction Dir = Direction::Maximize;
+  static constexpr unsigned Rows = ExplicitRow | ImplicitRow | OverheadRow;
+  static constexpr bool Connectivity = true;
+
+  static double connectivity(size_t coverage, const metric::Weights &w) {
+    return w.connectivityInstructions * coverage;
+  }
+  static void report(llvm::raw_ostream &os, double objective, double explicitC) {
+    os << "ILP connectivity: " << objective << " per covered instruction: "
+       << (explicitC > 0 ? objective / explicitC : 0.0) << "\n";
+  }
+};
+
+struct MaxManifest : ObjectivePolicy {
+  static constexpr const char *Name = "manifest";
+  static constexpr const char *Label = "max manifest. ";
+  static constexpr Direction Dir = Direction::Maximize;
+  static constexpr unsigned Rows = ExplicitRow | ImplicitRow | OverheadRow;
+
+  // every manifest has the same weight
+  static double manifest(double, size_t, const metric::Weights &w) { return w.connectivityManifest; }
+};
+
+struct MinSize : ObjectivePolicy {
+  static constexpr const char *Name = "size";
+  static constexpr const char *Label = "min Size. ";
+  static constexpr Direction Dir = Direction::Minimize;
+
+  static double manifest(double, size_t codeSize, const metric::Weights &) { return codeSize; }
+  static void report(llvm::raw_ostream &os, double objective, double) {
+    os << "ILP code size: " << objective << " instructions\n";
+  }
+};
+
+/**
+ * Objective specialized for `Policy` at compile time, rows the policy does not bound are never added and columns only
+ * touch the rows that exist. The loop over the columns is instantiated per policy, coefficients are inlined instead of
+ * dispatched per column.
+ * @tparam Policy derived from `ObjectivePolicy`
+ */
+template<typename Policy> class ObjectiveModule : public Objective {
+public:
+  std::string name() const override { return Policy::Name; }
+
+  Direction direction() const override { return Policy::Dir; }
+
+  ObjectiveRows addRows(Model &model, const ObjectiveBounds &bounds) const override {
+    ObjectiveRows rows{};
+    if constexpr ((Policy::Rows & ExplicitRow) != 0) {
+      rows.explicitC = model.addRow();
+      model.setRowName(rows.explicitC, "explicit");
+      model.setRowBounds(rows.explicitC, BoundType::Lower, bounds.explicitC, 0.0); // 0 < explicit <= inf
+    }
+    if constexpr ((Policy::Rows & ImplicitRow) != 0) {
+      rows.implicitC = model.addRow();
+      model.setRowName(rows.implicitC, "implicit");
+      model.setRowBounds(rows.implicitC, BoundType::Lower, bounds.implicitC, 0.0); // 0 < implicit <= inf
+    }
+    if constexpr ((Policy::Rows & OverheadRow) != 0) {
+      rows.overhead = model.addRow();
+      model.setRowName(rows.overhead, "overhead");
+      if (bounds.overhead > 0) {
+        model.setRowBounds(rows.overhead, BoundType::Upper, 0.0, bounds.overhead); // 0 < overhead <= bound
+      } else {
+        model.setRowBounds(rows.overhead, BoundType::Lower, bounds.overhead, 0); // 0 < overhead <= inf
+      }
+    }
+    if constexpr ((Policy::Rows & ManifestRow) != 0) {
+      rows.manifest = model.addRow();
+      model.setRowName(rows.manifest, "manifest");
+      model.setRowBounds(rows.manifest, BoundType::Lower, 0.0, 0.0);
+    }
+    return rows;
+  }
+
+  void addColumns(Model &model, const ObjectiveRows &rows, const std::vector<ColumnTerm> &terms,
+                  const metric::Weights &weights) const override {
+    for (auto &term : terms) {
+      if (term.col == 0) {
+        continue;
+      }
+      model.setObjective(term.col, coefficient(term, weights));
+      if (!term.bounded) {
+        continue;
+      }
+      if constexpr ((Policy::Rows & ExplicitRow) != 0) {
+        model.addCoefficient(rows.explicitC, term.col, term.values.explicitC);
+      }
+      if constexpr ((Policy::Rows & ImplicitRow) != 0) {
+        model.addCoefficient(rows.implicitC, term.col, term.values.implicitC);
+      }
+      if constexpr ((Policy::Rows & OverheadRow) != 0) {
+        model.addCoefficient(rows.overhead, term.col, term.values.overhead);
+      }
+      if constexpr ((Policy::Rows & ManifestRow) != 0) {
+        model.addCoefficient(rows.manifest, term.col, term.values.manifest);
+      }
+    }
+  }
+
+  bool needsConnectivity() const override { return Policy::Connectivity; }
+
+  void report(llvm::raw_ostream &os, double objective, double explicitC) const override {
+    Policy::report(os, objective, explicitC);
+  }
+
+  const char *label() const override { return Policy::Label; }
+
+private:
+  static double coefficient(const ColumnTerm &term, const metric::Weights &weights) {
+    switch (term.role) {
+    case ColumnRole::Manifest:
+      return Policy::manifest(term.overhead, term.codeSize, weights);
+    case ColumnRole::Explicit:
+      return Policy::explicitC(term.coverage, weights);
+    case ColumnRole::Implicit:
+      return Policy::implicitC(term.coverage, weights);
+    case ColumnRole::Connectivity:
+      return Policy::connectivity(term.coverage, weights);
+    case ColumnRole::Other:
+      break;
+    }
+    return 0;
+  }
+};
+
+/**
+ * Creates the objective named `name`, unknown names are a fatal error
+ */
+std::unique_ptr<Objective> createObjective(const std::string &name);
+} // namespace composition::graph::ilp
+
+#endif // COMPOSITION_GRAPH_ILP_OBJECTIVE_HPP
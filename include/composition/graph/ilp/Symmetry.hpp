@@ -0,0 +1,54 @@
+#ifndef COMPOSITION_GRAPH_ILP_SYMMETRY_HPP
+#define COMPOSITION_GRAPH_ILP_SYMMETRY_HPP
+
+#include <composition/graph/ilp/Model.hpp>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace composition::graph::ilp {
+/**
+ * A model whose classes of interchangeable binary columns, e.g., several hash checks over one function, are replaced by
+ * one integer column counting the selected members. Branch-and-bound then no longer enumerates permutations of them.
+ *
+ * Rows with every member of a class at the same coefficient take the count instead. Rows repeated once per member,
+ * like `c - mj >= 0`, are kept twice: once for a binary column set iff any member is selected and once for one set iff
+ * all of them are. The other copies are left empty and free, so row indices stay the same as in the original model.
+ */
+struct Collapsed {
+  Model model{};
+  /**
+   * Columns of the original model behind each column of the collapsed one, indexed by the collapsed column - 1. The
+   * any/all columns of a class have none.
+   */
+  std::vector<std::vector<int>> members{};
+  /**
+   * Column of the collapsed model and position in its class of each column of the original one, indexed by the
+   * column - 1
+   */
+  std::vector<std::pair<int, size_t>> origin{};
+  /**
+   * Number of classes collapsed, classes whose rows have other shapes stay as they are
+   */
+  size_t classes{};
+
+  /**
+   * Maps an integer solution of the collapsed model back to the original one. A count of k selects the first k members
+   * of its class, which breaks the symmetry between them.
+   * @param col the column of the original model
+   * @param value the value of a column of the collapsed model
+   * @return the value of `col`
+   */
+  double value(int col, const std::function<double(int)> &value) const;
+};
+
+/**
+ * Collapses the given classes of binary columns of `model`. A class is collapsed only if its members have the same
+ * kind, bounds and objective and every row touching them contains either all members at the same coefficient or one
+ * member and is repeated for every other member, otherwise swapping two members would change the model.
+ * @param classes candidate classes, e.g., the columns of manifests with the same coverage, cost and neighbours
+ */
+Collapsed collapseSymmetries(const Model &model, const std::vector<std::vector<int>> &classes);
+} // namespace composition::graph::ilp
+
+#endif // COMPOSITION_GRAPH_ILP_SYMMETRY_HPP
@@ -10,6 +10,18 @@ struct ManifestStats {
   size_t implicitC{};
   size_t hotness{};
   size_t hotnessProtectee{};
+  /**
+   * Static number of instructions the manifest adds to the program, i.e. the instructions of its undo values
+   */
+  size_t codeSize{};
+  /**
+   * Cost multiplier of the protection type of the manifest, see `Weights::protectionCosts`
+   */
+  double protectionCost{1.0};
+  /**
+   * Estimated extra dynamic cycles of the manifest, see `Performance::dynamicCost`
+   */
+  double dynamicOverhead{};
 
   double normalizedExplicitC{};
   double normalizedImplicitC{};
@@ -4,7 +4,13 @@
 #include <llvm/Analysis/BlockFrequencyInfo.h>
 #include <llvm/IR/BasicBlock.h>
 #include <llvm/IR/Function.h>
+#include <istream>
+#include <llvm/IR/Instruction.h>
 #include <llvm/IR/Module.h>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
 
 namespace composition::metric {
 // @src: https://github.com/rcorcs/llvm-heat-printer
@@ -49,6 +55,58 @@ public:
   static uint64_t getMaxFreq(llvm::Module &M,
                              llvm::function_ref<llvm::BlockFrequencyInfo *(llvm::Function &)> LookupBFI,
                              bool useHeuristic = true);
+
+  /**
+   * Estimates block frequencies for modules without a profile. The static heuristic frequencies of each function are
+   * taken relative to its entry and scaled by an entry count propagated along the call graph, starting with
+   * `StaticEntryCount` for every function without callers.
+   * @param M the Module
+   * @param LookupBFI the BlockFrequency lookup structure
+   * @return the estimated frequency of every block in a defined function
+   */
+  static std::unordered_map<llvm::BasicBlock *, uint64_t>
+  estimateBlockFreqs(llvm::Module &M, llvm::function_ref<llvm::BlockFrequencyInfo *(llvm::Function &)> LookupBFI);
+
+  /**
+   * Reads block frequencies from an external profile, e.g. converted from sampling. The JSON object has the optional
+   * members `functions`, mapping a function name to its sample `count` and to `blocks` (block index in the function to
+   * count), and `lines`, mapping "file:line" to a count. A block takes its count from `blocks`, else the highest count
+   * of its debug locations in `lines`, else the function `count` spread with the static heuristics. Blocks of
+   * functions without samples are cold.
+   * @param M the Module
+   * @param profile the JSON profile
+   * @param LookupBFI the BlockFrequency lookup structure
+   * @return the frequency of every block in a defined function
+   */
+  static std::unordered_map<llvm::BasicBlock *, uint64_t>
+  importBlockFreqs(llvm::Module &M, std::istream &profile,
+                   llvm::function_ref<llvm::BlockFrequencyInfo *(llvm::Function &)> LookupBFI);
+
+  /**
+   * Estimated cycles of executing `I` once, based on its opcode. Calls to a function in `callCosts` take the listed
+   * cost instead of the generic call cost.
+   * @param I the Instruction
+   * @param callCosts cycles per call of runtime hooks, keyed by function name
+   * @return the estimated cycles
+   */
+  static double instructionCost(const llvm::Instruction *I, const std::map<std::string, float> &callCosts);
+
+  /**
+   * Estimates the extra dynamic cycles of the instructions `instr`, i.e. the sum of the block frequency times the
+   * instruction cost. Instructions in blocks without a frequency are not counted.
+   * @param instr the instructions, e.g. the undo values of a manifest
+   * @param BFI the block frequencies
+   * @param callCosts cycles per call of runtime hooks, keyed by function name
+   * @return the estimated extra dynamic cycles
+   */
+  static double dynamicCost(const std::set<llvm::Instruction *> &instr,
+                            const std::unordered_map<llvm::BasicBlock *, uint64_t> &BFI,
+                            const std::map<std::string, float> &callCosts);
+
+  /**
+   * Estimated entry count of functions without callers
+   */
+  static constexpr uint64_t StaticEntryCount = 1000;
 };
 } // namespace composition::metric
 #endif // COMPOSITION_FRAMEWORK_METRIC_PERFORMANCE_HPP
@@ -21,6 +21,30 @@ struct Weights {
   float connectivityFunctions;
   float connectivityProtections;
 
+  /**
+   * Maximal estimated dynamic cost the manifests may add to a function, relative to the estimated dynamic cost of the
+   * function itself (e.g. 0.05 for 5%). 0 disables the budget.
+   */
+  float functionOverheadBudget;
+  /**
+   * Blocks whose frequency is at or above this percentile of all block frequencies form the hot region of a function
+   */
+  float hotRegionPercentile;
+  /**
+   * Like `functionOverheadBudget` but restricted to the hot region of each function
+   */
+  float hotRegionOverheadBudget;
+  /**
+   * Maximal number of instructions the manifests may add to a function, relative to the number of instructions of the
+   * function itself. 0 disables the budget.
+   */
+  float functionCodeSizeBudget;
+  /**
+   * Estimated cycles of one call to a runtime hook, keyed by the name of the called function. Replaces the generic call
+   * cost in the dynamic overhead estimate.
+   */
+  std::map<std::string, float> callCosts;
+
   Weights();
 
   explicit Weights(std::istream &i);
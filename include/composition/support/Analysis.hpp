@@ -23,6 +23,12 @@ public:
    */
   void addProtection(Manifest *m) { ManifestRegistry::Add(m); }
 
+  /**
+   * Adds alternative placements of one protection, at most one of them stays in the program
+   * @param variants the manifests
+   */
+  void addProtectionVariants(const std::vector<Manifest *> &variants) { ManifestRegistry::AddVariants(variants); }
+
   /**
    * Marks `value` as preserved. The callback allows to define a custom function call.
    * @param name of the pass
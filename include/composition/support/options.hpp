@@ -14,19 +14,44 @@ extern llvm::cl::opt<bool> AddCFG;
 extern llvm::cl::opt<std::string> WeightConfig;
 extern llvm::cl::opt<std::string> DumpStats;
 extern llvm::cl::opt<std::string> UseStrategy;
+extern llvm::cl::opt<int> RandomStarts;
+extern llvm::cl::opt<unsigned> RandomSeed;
+extern llvm::cl::opt<double> RefineTime;
+extern llvm::cl::opt<double> HotnessPercentile;
+extern llvm::cl::opt<uint64_t> HotnessLimit;
+extern llvm::cl::opt<std::string> BlockFrequencies;
+extern llvm::cl::opt<std::string> HotnessProfile;
+extern llvm::cl::opt<std::string> OverheadModel;
 extern llvm::cl::opt<std::string> PatchInfo;
 extern llvm::cl::opt<std::string> ILPProblem;
 extern llvm::cl::opt<std::string> ILPSolution;
 extern llvm::cl::opt<std::string> ILPSolutionReadable;
+extern llvm::cl::opt<std::string> ILPCache;
+extern llvm::cl::opt<std::string> ILPCheckpoint;
+extern llvm::cl::opt<bool> ILPCheckpointAccept;
+extern llvm::cl::list<double> ILPSweep;
+extern llvm::cl::opt<std::string> ILPSweepBound;
+extern llvm::cl::opt<std::string> ILPSweepOut;
 /*
  * List of global variables which can be used to control the ILP
  */
 extern llvm::cl::opt<int> ILPExplicitBound;
 extern llvm::cl::opt<int> ILPImplicitBound;
 extern llvm::cl::opt<double> ILPConnectivityBound;
+extern llvm::cl::opt<int> ILPConnectivityCap;
 extern llvm::cl::opt<double> ILPBlockConnectivityBound;
 extern llvm::cl::opt<double> ILPOverheadBound;
+extern llvm::cl::opt<int> ILPSizeBound;
 extern llvm::cl::opt<std::string> ILPObjective;
+extern llvm::cl::opt<std::string> ILPBackend;
+extern llvm::cl::opt<bool> ILPBreakSymmetry;
+extern llvm::cl::opt<std::string> ILPFormulation;
+extern llvm::cl::opt<std::string> ILPCoverage;
+extern llvm::cl::opt<int> ILPPortfolio;
+extern llvm::cl::opt<double> ILPTimeLimit;
+extern llvm::cl::opt<bool> ILPElastic;
+extern llvm::cl::opt<std::string> LPMethod;
+extern llvm::cl::opt<std::string> LPRounding;
 
 } // namespace composition::support
 #endif // COMPOSITION_FRAMEWORK_SUPPORT_OPTIONS_HPP
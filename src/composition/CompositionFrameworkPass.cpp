@@ -228,31 +228,102 @@ bool CompositionFrameworkPass::graphPass(llvm::Module &M) {
     w = metric::Weights(ifs);
   }
 
+  const std::string &source = composition::support::BlockFrequencies;
+  if (source != "auto" && source != "profile" && source != "static") {
+    llvm::report_fatal_error(llvm::Twine("Unknown block frequency source '") + source + "'");
+  }
+  const std::string &imported = composition::support::HotnessProfile;
+  bool hasProfile = Performance::hasProfiling(M);
+  if (imported.empty() && source == "profile" && !hasProfile) {
+    llvm::report_fatal_error("-cf-block-freq=profile requires a module with profile metadata");
+  }
+  bool staticBFI = imported.empty() && (source == "static" || !hasProfile);
+  if (!imported.empty()) {
+    dbgs() << "Importing block frequencies from " << imported << "\n";
+  } else if (staticBFI) {
+    dbgs() << "No profile used, estimating block frequencies from branch heuristics\n";
+  }
+
   std::unordered_map<llvm::BasicBlock *, uint64_t> BFI{};
-  for (auto &F : M) {
-    if (F.isDeclaration()) {
-      continue;
+  auto collectBFI = [&, this]() {
+    BFI.clear();
+    auto lookupBFI = [this](Function &F) { return &getAnalysis<BlockFrequencyInfoWrapperPass>(F).getBFI(); };
+    if (!imported.empty()) {
+      std::ifstream ifs(imported);
+      if (!ifs.good()) {
+        llvm::report_fatal_error(llvm::Twine("Could not read hotness profile '") + imported + "'");
+      }
+      BFI = Performance::importBlockFreqs(M, ifs, lookupBFI);
+      return;
     }
+    if (staticBFI) {
+      BFI = Performance::estimateBlockFreqs(M, lookupBFI);
+      return;
+    }
+    for (auto &F : M) {
+      if (F.isDeclaration()) {
+        continue;
+      }
 
-    auto &bfiPass = getAnalysis<BlockFrequencyInfoWrapperPass>(F);
-    auto &bf = bfiPass.getBFI();
-    for (auto &BB : F) {
-      BFI.insert({&BB, Performance::getBlockFreq(&BB, &bf, false)});
+      auto &bfiPass = getAnalysis<BlockFrequencyInfoWrapperPass>(F);
+      auto &bf = bfiPass.getBFI();
+      for (auto &BB : F) {
+        BFI.insert({&BB, Performance::getBlockFreq(&BB, &bf, false)});
+      }
     }
-  }
+  };
+  collectBFI();
 
   dbgs() << "Calculating Manifest dependencies\n";
   Graph->computeManifestDependencies();
+
+  // Manifests no overhead bound would accept are dropped before the conflicts are analyzed
+  if (auto hot = Graph->hotManifests(BFI); !hot.empty()) {
+    dbgs() << "Dropping " << hot.size() << " hot manifests\n";
+    for (auto *m : hot) {
+      ManifestRegistry::Remove(m);
+    }
+    cStats.filteredManifests = hot.size();
+
+    // Undo may have removed blocks
+    collectBFI();
+    Graph->destroy();
+    Graph = buildGraphFromManifests(ManifestRegistry::GetAll());
+    addCallGraph(Graph, M);
+    Graph->addHierarchy(M);
+    Graph->connectShadowNodes();
+    Graph->computeManifestDependencies();
+  }
   size_t totalInstructions = 0;
   for (auto &F: sensitiveFunctions)
     totalInstructions += Coverage::ValueToInstructions(F).size();
   std::set<Manifest *> accepted;
   if (composition::support::UseStrategy == "ilp") {
     dbgs() << "Running ILP\n on " << totalInstructions << "\n";
-    accepted = Graph->ilpConflictHandling(M, BFI, totalInstructions);
+    accepted = Graph->ilpConflictHandling(M, BFI, totalInstructions, w);
+  } else if (composition::support::UseStrategy == "lp") {
+    dbgs() << "Running LP relaxation and rounding\n";
+    accepted = Graph->lpConflictHandling(M, BFI, w);
+  } else if (composition::support::UseStrategy == "greedy") {
+    dbgs() << "Running greedy\n";
+    accepted = Graph->greedyConflictHandling(M, BFI, w);
+  } else if (composition::support::RandomStarts > 1 || composition::support::RandomSeed.getNumOccurrences() > 0) {
+    dbgs() << "Running " << composition::support::RandomStarts << " seeded random resolutions\n";
+    accepted = Graph->multiStartConflictHandling(M, BFI, w);
   } else {
     accepted = Graph->randomConflictHandling(M);
   }
+  if (composition::support::RefineTime > 0) {
+    dbgs() << "Refining the selection\n";
+    accepted = Graph->refineSelection(M, BFI, w, accepted);
+  }
+  // To compare against the measured slowdown
+  double estimatedCycles = 0.0;
+  for (auto *m : accepted) {
+    estimatedCycles += metric::Performance::dynamicCost(metric::Coverage::ValuesToInstructions(m->UndoValues()), BFI,
+                                                        w.callCosts);
+  }
+  dbgs() << "Estimated extra dynamic cycles of the accepted manifests: " << estimatedCycles << "\n";
   dbgs() << "Removing unselected manifests\n";
   // Just keep accepted manifests
   std::set<Manifest *> registered = ManifestRegistry::GetAll();
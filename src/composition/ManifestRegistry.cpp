@@ -4,6 +4,7 @@
 
 namespace composition {
 manifest_idx_t ManifestRegistry::index = manifest_idx_t(0);
+size_t ManifestRegistry::variantGroup = 0;
 
 void ManifestRegistry::Remove(Manifest *m) {
   auto &manifests = RegisteredManifests();
@@ -23,6 +24,14 @@ void ManifestRegistry::Add(Manifest *m) {
   RegisteredManifests().insert(m);
 }
 
+void ManifestRegistry::AddVariants(const std::vector<Manifest *> &variants) {
+  auto group = variantGroup++;
+  for (auto *m : variants) {
+    m->variantGroup = group;
+    Add(m);
+  }
+}
+
 void ManifestRegistry::destroy() {
   for (auto *m : RegisteredManifests()) {
     delete m;
@@ -25,6 +25,7 @@ void to_json(nlohmann::json &j, const Stats &s) {
   j = nlohmann::json{
       {"stats", s.stats},
       {"proposedManifests", s.proposedManifests},
+      {"filteredManifests", s.filteredManifests},
       {"actualManifests", s.actualManifests},
       {"cycles", s.cycles},
       {"conflicts", s.conflicts},
@@ -39,6 +40,7 @@ void to_json(nlohmann::json &j, const Stats &s) {
 void from_json(const nlohmann::json &j, Stats &s) {
   s.stats = j.at("stats").get<metric::Stats>();
   s.proposedManifests = j.at("proposedManifests").get<size_t>();
+  s.filteredManifests = j.value("filteredManifests", size_t(0));
   s.actualManifests = j.at("actualManifests").get<size_t>();
   s.cycles = j.at("cycles").get<size_t>();
   s.conflicts = j.at("conflicts").get<size_t>();
@@ -1,29 +1,182 @@
 #include <composition/graph/ILPSolver.hpp>
+#include <composition/graph/ilp/Cache.hpp>
+#include <composition/graph/ilp/Checkpoint.hpp>
+#include <composition/graph/ilp/Symmetry.hpp>
+#include <composition/profiler.hpp>
 #include <composition/support/options.hpp>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/Twine.h>
+#include <llvm/Support/ErrorHandling.h>
+#include <llvm/Support/FileSystem.h>
+#include <nlohmann/json.hpp>
 
 namespace composition::graph {
 
-ILPSolver::ILPSolver() {
-  lp = glp_create_prob();          // creates a problem object
-  glp_set_prob_name(lp, "sample"); // assigns a symbolic name to the problem object
-}
+ILPSolver::ILPSolver() : backend(ilp::createBackend(composition::support::ILPBackend)) {}
 
 ILPSolver::~ILPSolver() { destroy(); }
 
 void ILPSolver::destroy() {
-  if (lp != nullptr) {
-    glp_delete_prob(lp);
-  }
-  lp = nullptr;
+  backend.reset();
+  model = ilp::Model{};
+  collapsed.reset();
+  slacks.clear();
+  terms.clear();
+  modeValues.clear();
+  ELASTIC = 0;
 }
 
 void ILPSolver::init(const std::string &objectiveMode, double overheadBound, int explicitBound, int implicitBound,
                      double hotness, double hotnessProtectee) {
+  const std::string &formulation = composition::support::ILPFormulation;
+  if (formulation != "tight" && formulation != "legacy") {
+    llvm::report_fatal_error(llvm::Twine("Unknown ILP formulation '") + formulation + "'");
+  }
 
-  this->setMode(objectiveMode);
-  //after setting the mode we can set the objective direction, min or max
-  glp_set_obj_dir(lp, get_obj_dir());
-  addModeRows(overheadBound, explicitBound, implicitBound, hotness, hotnessProtectee);
+  objective = ilp::createObjective(objectiveMode);
+  model.direction = objective->direction();
+  auto rows = objective->addRows(model, {overheadBound, explicitBound, implicitBound});
+  EXPLICIT = rows.explicitC;
+  IMPLICIT = rows.implicitC;
+  OVERHEAD = rows.overhead;
+  MANIFEST = rows.manifest;
+  HOTNESS = model.addRow();
+  model.setRowName(HOTNESS, "hotness");
+  model.setRowBounds(HOTNESS, BoundType::Lower, hotness, 0.0); // 0 < unique <= inf
+  HOTNESS_PROTECTEE = model.addRow();
+  model.setRowName(HOTNESS_PROTECTEE, "hotnessProtectee");
+  model.setRowBounds(HOTNESS_PROTECTEE, BoundType::Lower, hotnessProtectee, 0.0); // 0 < unique <= inf
+
+  if (composition::support::ILPElastic) {
+    for (int row : {EXPLICIT, IMPLICIT, OVERHEAD}) {
+      if (row != 0) {
+        elastic(row);
+      }
+    }
+  }
+}
+
+void ILPSolver::elastic(int row) {
+  const ilp::Row &r = model.rows[row - 1];
+  double coefficient;
+  if (r.type == BoundType::Lower && r.lb > 0) {
+    // row + s >= lb
+    coefficient = 1.0;
+  } else if (r.type == BoundType::Upper) {
+    // row - s <= ub
+    coefficient = -1.0;
+  } else {
+    return;
+  }
+
+  auto col = model.addColumn();
+  model.setColumnName(col, "slack_" + r.name);
+  model.setColumnKind(col, ColumnKind::Continuous);
+  model.setColumnBounds(col, BoundType::Lower, 0.0, 0.0);
+  model.addCoefficient(row, col, coefficient);
+  slacks.insert({row, {col, coefficient}});
+}
+
+void ILPSolver::minimizeViolation(const ilp::Parameters &params) {
+  // Bounds are in different units, a slack counts relative to the bound it relaxes
+  std::map<int, double> scale{};
+  for (auto&[row, slack] : slacks) {
+    const ilp::Row &r = model.rows[row - 1];
+    scale[slack.first] = 1.0 / std::max(1.0, std::abs(r.type == BoundType::Lower ? r.lb : r.ub));
+  }
+
+  ilp::Model violation = model;
+  violation.direction = Direction::Minimize;
+  for (auto &column : violation.columns) {
+    column.objective = 0.0;
+  }
+  for (auto&[col, weight] : scale) {
+    violation.columns[col - 1].objective = weight;
+  }
+  auto violationBackend = ilp::createBackend(composition::support::ILPBackend);
+  violationBackend->load(violation);
+  auto status = violationBackend->solve(params);
+  if (status != ilp::Status::Optimal && !(params.timeLimit > 0 && status == ilp::Status::Feasible)) {
+    llvm::report_fatal_error(llvm::Twine("The elastic ILP could not be solved, status: ") + ilp::toString(status));
+  }
+  double least = violationBackend->objectiveValue();
+  llvm::dbgs() << "ILP elastic: least relative violation " << least << "\n";
+
+  ELASTIC = model.addRow();
+  model.setRowName(ELASTIC, "elastic");
+  model.setRowBounds(ELASTIC, BoundType::Upper, 0.0, least + std::max(1e-6, least * 1e-9));
+  for (auto&[col, weight] : scale) {
+    model.addCoefficient(ELASTIC, col, weight);
+  }
+}
+
+double ILPSolver::columnValue(int col) const {
+  if (collapsed) {
+    return collapsed->value(col, [this](int c) { return backend->columnValue(c); });
+  }
+  return backend->columnValue(col);
+}
+
+double ILPSolver::columnValue(int col, const std::vector<double> &values) const {
+  if (collapsed) {
+    return collapsed->value(col, [&values](int c) { return values[c - 1]; });
+  }
+  return values[col - 1];
+}
+
+std::vector<uint64_t> ILPSolver::acceptedManifests(const std::vector<double> &values) const {
+  std::vector<uint64_t> result{};
+  for (auto&[col, mIdx] : colsToM) {
+    if (columnValue(col, values) > 0.5) {
+      result.push_back(static_cast<uint64_t>(mIdx));
+    }
+  }
+  return result;
+}
+
+double ILPSolver::rowValue(int row) const {
+  double value = backend->rowValue(row);
+  if (auto found = slacks.find(row); found != slacks.end()) {
+    auto[col, coefficient] = found->second;
+    value -= coefficient * columnValue(col);
+  }
+  return value;
+}
+
+ilp::ColumnValues ILPSolver::solutionValues() const {
+  ilp::ColumnValues result{};
+  for (auto&[col, values] : modeValues) {
+    double value = columnValue(col);
+    result.overhead += values.overhead * value;
+    result.explicitC += values.explicitC * value;
+    result.implicitC += values.implicitC * value;
+  }
+  return result;
+}
+
+void ILPSolver::printModeILPResults() const {
+  auto solution = solutionValues();
+  auto explicit_re = static_cast<uint64_t>(std::lround(solution.explicitC));
+  auto implicit_re = static_cast<uint64_t>(std::lround(solution.implicitC));
+  double overhead_re = solution.overhead;
+  llvm::dbgs() << "ILP resuls. " << objective->label() << " overhead: " << overhead_re
+               << " explicit instruction coverage: " << explicit_re << " implicit instruction coverage: " << implicit_re
+               << "\n";
+  objective->report(llvm::dbgs(), backend->objectiveValue(), static_cast<double>(explicit_re));
+}
+
+void ILPSolver::printViolatedBounds() const {
+  for (auto&[row, slack] : slacks) {
+    double violation = columnValue(slack.first);
+    if (violation > 1e-6) {
+      const ilp::Row &r = model.rows[row - 1];
+      llvm::dbgs() << "ILP elastic: " << r.name << " bound " << (r.type == BoundType::Lower ? r.lb : r.ub)
+                   << " violated by " << violation << "\n";
+    }
+  }
 }
 
 void ILPSolver::addManifests(const std::unordered_map<manifest_idx_t, Manifest *> &manifests,
@@ -33,20 +186,26 @@ void ILPSolver::addManifests(const std::unordered_map<manifest_idx_t, Manifest *
     // column N
     std::ostringstream os;
     os << "m" << m->index;
-    auto col = glp_add_cols(lp, 1);
-    glp_set_col_name(lp, col, os.str().c_str());                  // assigns name m_n to nth column
-    glp_set_col_kind(lp, col, GLP_BV);                            // values are binary
-    glp_set_col_bnds(lp, col, GLP_DB, 0.0, 1.0);                  // values are binary
-    glp_set_obj_coef(lp, col, get_obj_coef_manifest(costFunction(stats[mIdx]))); // costs
+    auto col = model.addColumn();
+    model.setColumnName(col, os.str()); // assigns name m_n to nth column
+    model.setColumnKind(col, ColumnKind::Binary); // values are binary
+    model.setColumnBounds(col, BoundType::Double, 0.0, 1.0); // values are binary
+    auto &t = term(col); // costs
+    t.role = ilp::ColumnRole::Manifest;
+    t.overhead = costFunction(stats[mIdx]);
+    t.codeSize = stats[mIdx].codeSize;
 
     colsToM.insert({col, m->index});
+    manifestNames.insert({m->index, m->name});
+    // Raw profile counts reach 1e9, the tight formulation uses the normalized hotness to keep the matrix well scaled
+    bool normalized = composition::support::ILPFormulation != "legacy";
     // depending on the objective columns need to be added differently
     addModeColumns(col,
                    costFunction(stats[mIdx]) /*overhead*/,
                    0 /*explicit(only instructions)*/,//stats[mIdx].explicitC,
                    0 /*implicit(only edges)*/,
-                   stats[mIdx].hotness,
-                   stats[mIdx].hotnessProtectee, /*isManifest*/
+                   normalized ? stats[mIdx].normalizedHotness : stats[mIdx].hotness,
+                   normalized ? stats[mIdx].normalizedHotnessProtectee : stats[mIdx].hotnessProtectee, /*isManifest*/
                    1);
   }
 }
@@ -72,7 +231,18 @@ void ILPSolver::addCycles(const std::set<std::set<manifest_idx_t>> &cycles) {
   }
 }
 
+void ILPSolver::addVariantGroups(const std::set<std::set<manifest_idx_t>> &groups) {
+  // Add variant groups
+  for (auto &&g : groups) {
+    variantGroup(g);
+  }
+}
+
 void ILPSolver::addConnectivity(const std::set<std::set<manifest_idx_t>> &connectivities) {
+  // A bound of zero is satisfied by any selection, the rows would only bloat the model
+  if (ILPConnectivityBound <= 0) {
+    return;
+  }
   // Add connectivity
   for (auto &&c : connectivities) {
     connectivity(c, ILPConnectivityBound);
@@ -80,6 +250,9 @@ void ILPSolver::addConnectivity(const std::set<std::set<manifest_idx_t>> &connec
 }
 
 void ILPSolver::addBlockConnectivity(const std::set<std::set<manifest_idx_t>> &blockConnectivities) {
+  if (ILPBlockConnectivityBound <= 0) {
+    return;
+  }
   // Add  blockConnectivity
   for (auto &&c : blockConnectivities) {
     blockConnectivity(c, ILPBlockConnectivityBound);
@@ -87,219 +260,663 @@ void ILPSolver::addBlockConnectivity(const std::set<std::set<manifest_idx_t>> &b
 }
 
 void ILPSolver::addExplicitCoverages(const std::map<llvm::Instruction *, std::set<manifest_idx_t>> &coverage) {
-  // Add explicit coverage
+  // Group instructions by the set of manifests covering them
+  std::map<std::set<manifest_idx_t>, std::vector<llvm::Instruction *>> groups{};
   for (auto &[I, c] : coverage) {
-    explicitCoverage(I, c);
+    groups[c].push_back(I);
   }
+
+  // Add explicit coverage, one column per group
+  for (auto &[c, instructions] : groups) {
+    auto col = explicitCoverage(c, instructions.size());
+    coverageGroups.insert({c, {col, instructions.size()}});
+    for (auto *I : instructions) {
+      ItoCols.insert({I, col});
+    }
+    if (objective->needsConnectivity()) {
+      connectivityCoverage(c, coverageGroups.at(c));
+    }
+  }
+  llvm::dbgs() << "ILP coverage groups:" << groups.size() << " instructions:" << coverage.size() << "\n";
+}
+
+std::string ILPSolver::configuration(const ilp::Parameters &params) const {
+  std::ostringstream os;
+  os << backend->name() << ";" << objective->name() << ";" << params.presolve << ";" << params.cuts << ";"
+     << static_cast<int>(params.branching) << ";" << params.timeLimit << ";"
+     << composition::support::ILPBreakSymmetry << ";";
+  for (auto &[mIdx, name] : manifestNames) {
+    os << mIdx << "=" << name << ";";
+  }
+  return os.str();
+}
+
+std::pair<std::set<manifest_idx_t>, std::set<manifest_idx_t>> ILPSolver::selection(
+    const std::function<bool(int)> &isSet) const {
+  std::set<manifest_idx_t> acceptedManifests{};
+  for (auto&[col, mIdx] : colsToM) {
+    if (isSet(col)) {
+      acceptedManifests.insert(mIdx);
+      // TODO: calculate implicit coverage based on the accepted edges
+    }
+  }
+
+  std::set<manifest_idx_t> acceptedEdges{};
+  for (auto&[col, eIdx] : colsToE) {
+    if (isSet(col)) {
+      acceptedEdges.insert(eIdx);
+    }
+  }
+  return {acceptedManifests, acceptedEdges};
+}
+
+void ILPSolver::addObjectiveColumns() {
+  objective->addColumns(model, {EXPLICIT, IMPLICIT, OVERHEAD, MANIFEST}, terms, weights);
+  terms.clear();
 }
 
 std::pair<std::set<manifest_idx_t>, std::set<manifest_idx_t>> ILPSolver::run() {
-  int dataSize = static_cast<int>(rows.size());
-  // now prepend the required position zero placeholder (any value will do but zero is safe)
-  // first create length one vectors using default member construction
-  std::vector<int> iav(1, 0);
-  std::vector<int> jav(1, 0);
-  std::vector<double> arv(1, 0);
+  addObjectiveColumns();
+  llvm::dbgs() << "ILP sanity rows:" << model.numRows() << " columns:" << model.numColumns()
+               << " coefs:" << model.numCoefficients() << "\n";
+
+  ilp::Parameters params = solveParameters();
+
+  // An unchanged model has the same optimal solution, skip the solve
+  std::optional<ilp::Cache> cache{};
+  std::string key{};
+  if (!composition::support::ILPCache.empty() && composition::support::ILPSweep.empty()) {
+    cache.emplace(composition::support::ILPCache.getValue());
+    key = ilp::Cache::key(model, configuration(params));
+    if (auto columns = cache->lookup(key)) {
+      llvm::dbgs() << "ILP cache hit: " << key << "\n";
+      return selection([&](int col) { return columns->find(model.columnName(col)) != columns->end(); });
+    }
+    llvm::dbgs() << "ILP cache miss: " << key << "\n";
+  }
 
-  // then concatenate these with the original data vectors
-  iav.insert(iav.end(), rows.begin(), rows.end());
-  jav.insert(jav.end(), cols.begin(), cols.end());
-  arv.insert(arv.end(), coeffs.begin(), coeffs.end());
+  // Satisfiable bounds need no slack, the violation is only minimized once the model is infeasible without it
+  bool slacksFixed = !slacks.empty() && ELASTIC == 0;
+  for (auto&[row, slack] : slacks) {
+    model.setColumnBounds(slack.first, slacksFixed ? BoundType::Fixed : BoundType::Lower, 0.0, 0.0);
+  }
 
-  llvm::dbgs() << "ILP sanity rows:" << dataSize << " columns:" << cols.size() << " coefs:" << coeffs.size()<<"\n";
-  glp_load_matrix(lp, dataSize, &iav[0], &jav[0], &arv[0]); // calls the routine glp_load_matrix
+  // Interchangeable manifests are solved as one count, column values are mapped back by `columnValue`
+  collapsed.reset();
+  if (composition::support::ILPBreakSymmetry) {
+    collapsed = ilp::collapseSymmetries(model, symmetryClasses);
+    llvm::dbgs() << "ILP symmetry: " << collapsed->classes << " of " << symmetryClasses.size()
+                 << " classes collapsed, " << model.numColumns() << " columns collapsed to "
+                 << collapsed->model.numColumns() << "\n";
+  }
+  const ilp::Model &loaded = collapsed ? collapsed->model : model;
+  backend->load(loaded);
 
   // Write problem definition
   if (!composition::support::ILPProblem.empty()) {
     llvm::dbgs() << "Writing problem to" << composition::support::ILPProblem.getValue() << "\n";
-    glp_write_lp(lp, nullptr, composition::support::ILPProblem.getValue().c_str());
+    backend->writeProblem(composition::support::ILPProblem.getValue());
   }
 
-  glp_iocp params{};
-  glp_init_iocp(&params);
-
-  params.gmi_cuts = GLP_ON;
-  params.br_tech = GLP_BR_PCH;
-  params.presolve = GLP_ON;
-
-  int mip_ecode = glp_intopt(lp, &params);
-  int mip_status = glp_mip_status(lp);
-  llvm::dbgs() << "MIP exit code: " << mip_ecode << " status code: " << mip_ecode << "\n";
-  // No error occured
-  assert(mip_ecode == 0);
-  // Solution is INTEGER OPTIMAL
-  assert(mip_status == GLP_OPT);
+  // Improved incumbents are saved as they are found, a restarted solve of the same model resumes from the last one
+  std::optional<ilp::Checkpoint> checkpoint{};
+  std::vector<double> warmStart{};
+  if (!composition::support::ILPCheckpoint.empty()) {
+    checkpoint.emplace(composition::support::ILPCheckpoint.getValue(), ilp::Cache::key(loaded, configuration(params)),
+                       model.direction);
+    if (auto saved = checkpoint->load(loaded)) {
+      if (composition::support::ILPCheckpointAccept) {
+        llvm::dbgs() << "ILP checkpoint accepted, objective: " << saved->objective << "\n";
+        return selection([&](int col) { return columnValue(col, saved->values) > 0.5; });
+      }
+      llvm::dbgs() << "ILP checkpoint found, warm starting from objective: " << saved->objective << "\n";
+      warmStart = std::move(saved->values);
+      params.warmStart = &warmStart;
+    }
+    params.onIncumbent = [&](const std::vector<double> &values, double objective) {
+      checkpoint->store(loaded, values, objective, acceptedManifests(values));
+    };
+  }
 
-  auto objective_result = glp_mip_obj_val(lp);
+  Profiler solveProfiler{};
+  auto status = composition::support::ILPPortfolio > 1 ? portfolio(params, loaded) : backend->solve(params);
+  llvm::dbgs() << "ILP backend: " << backend->name() << " status: " << ilp::toString(status)
+               << " formulation: " << composition::support::ILPFormulation << " time: " << solveProfiler.stop()
+               << "s\n";
+  if (slacksFixed && status == ilp::Status::Infeasible) {
+    llvm::dbgs() << "ILP elastic: the bounds cannot be met, minimizing their violation\n";
+    for (auto&[row, slack] : slacks) {
+      model.setColumnBounds(slack.first, BoundType::Lower, 0.0, 0.0);
+    }
+    minimizeViolation(params);
+    return run();
+  }
+  // Solution is INTEGER OPTIMAL, or the best incumbent at the time limit
+  if (status != ilp::Status::Optimal && !(params.timeLimit > 0 && status == ilp::Status::Feasible)) {
+    llvm::report_fatal_error(llvm::Twine("The ILP could not be solved, status: ") + ilp::toString(status) +
+        (composition::support::ILPElastic ? "" : ". -cf-ilp-elastic relaxes the coverage and overhead bounds"));
+  }
 
   // Write machine readable solution
   if (!composition::support::ILPSolution.empty()) {
-    glp_write_mip(lp, composition::support::ILPSolution.getValue().c_str());
+    backend->writeSolution(composition::support::ILPSolution.getValue());
   }
 
   // Write human readable solution
   if (!composition::support::ILPSolutionReadable.empty()) {
-    glp_print_mip(lp, composition::support::ILPSolutionReadable.getValue().c_str());
+    backend->writeReadableSolution(composition::support::ILPSolutionReadable.getValue());
   }
 
-  std::set<manifest_idx_t> acceptedManifests{};
+  // Backends without incumbent callbacks only checkpoint the final solution
+  if (checkpoint) {
+    std::vector<double> values(static_cast<size_t>(loaded.numColumns()));
+    for (int col = 1; col <= loaded.numColumns(); ++col) {
+      values[col - 1] = backend->columnValue(col);
+    }
+    checkpoint->store(loaded, values, backend->objectiveValue(), acceptedManifests(values));
+  }
+
+  auto result = selection([this](int col) { return columnValue(col) > 0.5; });
+  printModeILPResults();
+  printViolatedBounds();
+
+  // A time limit incumbent depends on the timing, the next build must solve again instead of reusing it
+  if (cache && status != ilp::Status::Optimal) {
+    llvm::dbgs() << "ILP cache: not storing the " << ilp::toString(status) << " solution\n";
+  } else if (cache) {
+    std::set<std::string> columns{};
+    for (auto&[col, mIdx] : colsToM) {
+      if (result.first.find(mIdx) != result.first.end()) {
+        columns.insert(model.columnName(col));
+      }
+    }
+    for (auto&[col, eIdx] : colsToE) {
+      if (result.second.find(eIdx) != result.second.end()) {
+        columns.insert(model.columnName(col));
+      }
+    }
+    cache->store(key, columns);
+  }
+
+  return result;
+}
+
+std::pair<std::map<manifest_idx_t, double>, double> ILPSolver::relax(ilp::LPMethod method) {
+  addObjectiveColumns();
+  llvm::dbgs() << "LP relaxation rows:" << model.numRows() << " columns:" << model.numColumns()
+               << " coefs:" << model.numCoefficients() << "\n";
+
+  ilp::Parameters params{};
+  params.relaxation = true;
+  params.lpMethod = method;
+
+  backend->load(model);
+  auto status = backend->solve(params);
+  llvm::dbgs() << "LP backend: " << backend->name() << " status: " << ilp::toString(status) << "\n";
+  if (status != ilp::Status::Optimal) {
+    llvm::report_fatal_error(llvm::Twine("The LP relaxation could not be solved, status: ") + ilp::toString(status));
+  }
+
+  std::map<manifest_idx_t, double> values{};
   for (auto&[col, mIdx] : colsToM) {
-    if (glp_mip_col_val(lp, col) == 1) {
-      acceptedManifests.insert(mIdx);
-      // TODO: calculate implicit coverage based on the accepted edges
+    values[mIdx] = columnValue(col);
+  }
+  return {values, backend->objectiveValue()};
+}
+
+std::vector<ilp::Parameters> portfolioParameters(const ilp::Parameters &base, size_t size) {
+  std::vector<ilp::Parameters> result{base};
+  auto add = [&](ilp::Branching branching, ilp::Backtracking backtracking, bool cuts, bool presolve) {
+    ilp::Parameters p = base;
+    p.branching = branching;
+    p.backtracking = backtracking;
+    p.cuts = cuts;
+    p.presolve = presolve;
+    result.push_back(p);
+  };
+  add(ilp::Branching::DriebeckTomlin, ilp::Backtracking::BestLocalBound, true, true);
+  add(ilp::Branching::PseudoCost, ilp::Backtracking::BestProjection, false, true);
+  add(ilp::Branching::MostFractional, ilp::Backtracking::DepthFirst, true, false);
+  add(ilp::Branching::PseudoCost, ilp::Backtracking::DepthFirst, false, false);
+  add(ilp::Branching::DriebeckTomlin, ilp::Backtracking::BestProjection, true, false);
+  add(ilp::Branching::LastFractional, ilp::Backtracking::BreadthFirst, false, true);
+  add(ilp::Branching::FirstFractional, ilp::Backtracking::BestLocalBound, true, true);
+  result.resize(std::min(size, result.size()));
+  return result;
+}
+
+ilp::Status ILPSolver::portfolio(const ilp::Parameters &params, const ilp::Model &loaded) {
+  auto configurations = portfolioParameters(params, static_cast<size_t>(composition::support::ILPPortfolio));
+  auto size = static_cast<int>(configurations.size());
+
+  struct Run {
+    ilp::Status status = ilp::Status::Undefined;
+    double objective{};
+    double time{};
+    std::string summary{};
+    std::string solution{};
+    std::string error{};
+  };
+  std::vector<Run> runs(configurations.size());
+  std::atomic<bool> cancel{false};
+  std::atomic<int> winner{-1};
+
+  // Each run owns its backend for its whole lifetime, solvers like GLPK keep their memory per thread. The solution of
+  // the winner is handed over through its solution file. Runs are quiet, streams are not shared between threads, and
+  // report after the join.
+#pragma omp parallel for num_threads(size) schedule(static, 1)
+  for (int i = 0; i < size; ++i) {
+    auto p = configurations[i];
+    p.cancel = &cancel;
+    p.quiet = true;
+
+    auto b = ilp::createBackend(composition::support::ILPBackend);
+    b->load(loaded);
+    Profiler profiler{};
+    auto &run = runs[i];
+    run.status = b->solve(p);
+    run.time = profiler.stop();
+    run.summary = b->summary();
+    if (run.status == ilp::Status::Optimal) {
+      int none = -1;
+      if (winner.compare_exchange_strong(none, i)) {
+        cancel = true;
+      }
+    }
+    if (run.status == ilp::Status::Optimal || run.status == ilp::Status::Feasible) {
+      run.objective = b->objectiveValue();
+      llvm::SmallString<128> file{};
+      if (auto ec = llvm::sys::fs::createTemporaryFile("cf-ilp-portfolio", "sol", file)) {
+        run.error = ec.message();
+      } else {
+        b->writeSolution(file.str().str());
+        run.solution = file.str().str();
+      }
     }
   }
 
-  std::set<manifest_idx_t> acceptedEdges{};
-  for (auto&[col, eIdx] : colsToE) {
-    if (glp_mip_col_val(lp, col) == 1) {
-      acceptedEdges.insert(eIdx);
+  for (int i = 0; i < size; ++i) {
+    llvm::dbgs() << "ILP portfolio run " << i << " (" << ilp::describe(configurations[i])
+                 << ") status: " << ilp::toString(runs[i].status) << " objective: " << runs[i].objective
+                 << " time: " << runs[i].time << "s " << runs[i].summary << "\n";
+    if (!runs[i].error.empty()) {
+      llvm::dbgs() << "ILP portfolio run " << i << " could not save its solution: " << runs[i].error << "\n";
     }
   }
-  printModeILPResults();
 
-  return {acceptedManifests, acceptedEdges};
+  // The proven optimum wins, another optimal run takes over if its solution could not be saved. Without one, e.g. at
+  // the time limit, the best saved incumbent does.
+  int best = winner;
+  if (best >= 0 && runs[best].solution.empty()) {
+    best = -1;
+    for (int i = 0; i < size && best < 0; ++i) {
+      if (runs[i].status == ilp::Status::Optimal && !runs[i].solution.empty()) {
+        best = i;
+      }
+    }
+    if (best < 0) {
+      llvm::report_fatal_error(llvm::Twine("Could not save the optimal ILP solution of portfolio run ") +
+          llvm::Twine(winner.load()) + ": " + runs[winner].error);
+    }
+  }
+  if (best < 0) {
+    for (int i = 0; i < size; ++i) {
+      if (runs[i].status != ilp::Status::Feasible || runs[i].solution.empty()) {
+        continue;
+      }
+      if (best < 0 || (model.direction == Direction::Minimize ? runs[i].objective < runs[best].objective
+                                                              : runs[i].objective > runs[best].objective)) {
+        best = i;
+      }
+    }
+  }
+
+  if (best < 0) {
+    for (auto &run : runs) {
+      if (run.status == ilp::Status::Feasible && !run.error.empty()) {
+        llvm::report_fatal_error(llvm::Twine("Could not save an ILP solution of the portfolio: ") + run.error);
+      }
+    }
+  }
+  ilp::Status status = best >= 0 ? runs[best].status : runs.front().status;
+  if (best >= 0) {
+    llvm::dbgs() << "ILP portfolio winner: run " << best << " (" << ilp::describe(configurations[best]) << ")\n";
+    if (!backend->readSolution(runs[best].solution)) {
+      llvm::report_fatal_error(llvm::Twine("Could not read the ILP solution of the portfolio from ") +
+          runs[best].solution);
+    }
+  }
+  for (auto &run : runs) {
+    if (!run.solution.empty()) {
+      llvm::sys::fs::remove(run.solution);
+    }
+  }
+  return status;
+}
+
+ilp::Parameters ILPSolver::solveParameters() const {
+  ilp::Parameters params{};
+  params.cuts = true;
+  params.branching = ilp::Branching::PseudoCost;
+  params.presolve = true;
+  params.timeLimit = composition::support::ILPTimeLimit;
+  return params;
+}
+
+void ILPSolver::sweep() {
+  ilp::Parameters params = solveParameters();
+  const std::string &bound = composition::support::ILPSweepBound;
+  int row = 0;
+  if (bound == OVERHEAD_OBJ) {
+    row = OVERHEAD;
+  } else if (bound == EXPLICIT_OBJ) {
+    row = EXPLICIT;
+  } else if (bound == IMPLICIT_OBJ) {
+    row = IMPLICIT;
+  } else {
+    llvm::report_fatal_error(llvm::Twine("Unknown bound '") + bound + "' for -cf-ilp-sweep-bound");
+  }
+  if (row == 0) {
+    llvm::report_fatal_error(llvm::Twine("The ") + bound + " bound is the optimized objective and cannot be swept");
+  }
+
+  struct Point {
+    double bound;
+    ilp::Status status;
+    double overhead;
+    double explicitC;
+    double implicitC;
+  };
+  std::vector<Point> points{};
+  // Only the bounds change, every solve starts from the solution of the previous one (the configured bound first).
+  // Backends without warm starts ignore it.
+  int columns = collapsed ? collapsed->model.numColumns() : model.numColumns();
+  std::vector<double> incumbent(static_cast<size_t>(columns));
+  for (int col = 1; col <= columns; ++col) {
+    incumbent[col - 1] = backend->columnValue(col);
+  }
+  params.warmStart = &incumbent;
+  for (double value : composition::support::ILPSweep) {
+    if (row == OVERHEAD) {
+      backend->setRowBounds(row, BoundType::Upper, 0.0, value);
+    } else {
+      backend->setRowBounds(row, BoundType::Lower, value, 0.0);
+    }
+
+    auto status = backend->solve(params);
+    Point p{value, status, 0, 0, 0};
+    if (status == ilp::Status::Optimal || status == ilp::Status::Feasible) {
+      auto solution = solutionValues();
+      p.overhead = solution.overhead;
+      p.explicitC = solution.explicitC;
+      p.implicitC = solution.implicitC;
+      for (int col = 1; col <= columns; ++col) {
+        incumbent[col - 1] = backend->columnValue(col);
+      }
+    }
+    llvm::dbgs() << "ILP sweep " << bound << " bound: " << value << " status: " << ilp::toString(status)
+                 << " overhead: " << p.overhead << " explicit: " << p.explicitC << " implicit: " << p.implicitC << "\n";
+    points.push_back(p);
+  }
+
+  auto solved = [](const Point &p) { return p.status == ilp::Status::Optimal || p.status == ilp::Status::Feasible; };
+  auto dominates = [](const Point &a, const Point &b) {
+    return a.overhead <= b.overhead && a.explicitC >= b.explicitC && a.implicitC >= b.implicitC &&
+        (a.overhead < b.overhead || a.explicitC > b.explicitC || a.implicitC > b.implicitC);
+  };
+
+  nlohmann::json table = nlohmann::json::array();
+  for (auto &p : points) {
+    bool pareto = solved(p) && std::none_of(points.begin(), points.end(), [&](const Point &q) {
+      return solved(q) && dominates(q, p);
+    });
+    table.push_back({{"bound", p.bound},
+                     {"status", ilp::toString(p.status)},
+                     {"overhead", p.overhead},
+                     {"explicit", p.explicitC},
+                     {"implicit", p.implicitC},
+                     {"pareto", pareto}});
+  }
+  std::ofstream file(composition::support::ILPSweepOut.getValue());
+  file << nlohmann::json{{"objective", composition::support::ILPObjective.getValue()}, {"bound", bound},
+                         {"points", table}}.dump(4) << "\n";
+
+  // Back to the configured point
+  const ilp::Row &configured = model.rows[row - 1];
+  backend->setRowBounds(row, configured.type, configured.lb, configured.ub);
 }
 
 void ILPSolver::conflict(std::pair<manifest_idx_t, manifest_idx_t> pair) {
   // m1 and m2 conflict; m1 + m2 <= 1
-  auto row = glp_add_rows(lp, 1);
-  glp_set_row_bnds(lp, row, GLP_UP, 0.0, 1.0);
+  auto row = model.addRow();
+  model.setRowBounds(row, BoundType::Upper, 0.0, 1.0);
   std::ostringstream os;
   os << "conflict_" << pair.first << "_" << pair.second;
-  glp_set_row_name(lp, row, os.str().c_str());
+  model.setRowName(row, os.str());
 
-  rows.push_back(row);
-  cols.push_back(colsToM.right.at(pair.first));
-  coeffs.push_back(1.0);
+  model.addCoefficient(row, colsToM.right.at(pair.first), 1.0);
 
-  rows.push_back(row);
-  cols.push_back(colsToM.right.at(pair.second));
-  coeffs.push_back(1.0);
+  model.addCoefficient(row, colsToM.right.at(pair.second), 1.0);
 }
 
 void ILPSolver::dependency(std::pair<manifest_idx_t, manifest_idx_t> pair) {
   // m1 depends on m2; m1 <= m2; m1 - m2 <= 0
-  auto row = glp_add_rows(lp, 1);
-  glp_set_row_bnds(lp, row, GLP_UP, 0.0, 0.0);
+  auto row = model.addRow();
+  model.setRowBounds(row, BoundType::Upper, 0.0, 0.0);
   std::ostringstream os;
   os << "dependency_" << pair.first << "_" << pair.second;
-  glp_set_row_name(lp, row, os.str().c_str());
+  model.setRowName(row, os.str());
 
-  rows.push_back(row);
-  cols.push_back(colsToM.right.at(pair.first));
-  coeffs.push_back(1.0);
+  model.addCoefficient(row, colsToM.right.at(pair.first), 1.0);
 
-  rows.push_back(row);
-  cols.push_back(colsToM.right.at(pair.second));
-  coeffs.push_back(-1.0);
+  model.addCoefficient(row, colsToM.right.at(pair.second), -1.0);
 }
 
 void ILPSolver::cycle(const std::set<manifest_idx_t> &ms) {
   // m1..mN form a cycle; m1+m2+..+mN <= N-1
-  auto row = glp_add_rows(lp, 1);
-  glp_set_row_bnds(lp, row, GLP_UP, 0.0, ms.size() - 1);
+  auto row = model.addRow();
+  model.setRowBounds(row, BoundType::Upper, 0.0, ms.size() - 1);
   std::ostringstream os;
   os << "cycle_" << cycleCount++;
-  glp_set_row_name(lp, row, os.str().c_str());
+  model.setRowName(row, os.str());
+
+  for (auto &idx : ms) {
+    model.addCoefficient(row, colsToM.right.at(idx), 1.0);
+  }
+}
+
+void ILPSolver::variantGroup(const std::set<manifest_idx_t> &ms) {
+  // m1..mN are alternative placements; m1+m2+..+mN <= 1
+  auto row = model.addRow();
+  model.setRowBounds(row, BoundType::Upper, 0.0, 1.0);
+  std::ostringstream os;
+  os << "variant_" << variantCount++;
+  model.setRowName(row, os.str());
 
   for (auto &idx : ms) {
-    rows.push_back(row);
-    cols.push_back(colsToM.right.at(idx));
-    coeffs.push_back(1.0);
+    model.addCoefficient(row, colsToM.right.at(idx), 1.0);
   }
 }
 
 void ILPSolver::connectivity(const std::set<manifest_idx_t> &ms, double targetConnectivity) {
   // m1..mN protect an Instruction; m1+m2+..+mN >= min(N, targetConnectivity)
-  auto row = glp_add_rows(lp, 1);
-  glp_set_row_bnds(lp, row, GLP_LO, std::min((double) ms.size(), targetConnectivity), 0.0);
+  auto row = model.addRow();
+  model.setRowBounds(row, BoundType::Lower, std::min((double) ms.size(), targetConnectivity), 0.0);
   std::ostringstream os;
   os << "connectivity_" << connectivityCount++;
-  glp_set_row_name(lp, row, os.str().c_str());
+  model.setRowName(row, os.str());
 
   for (auto &idx : ms) {
-    rows.push_back(row);
-    cols.push_back(colsToM.right.at(idx));
-    coeffs.push_back(1.0);
+    model.addCoefficient(row, colsToM.right.at(idx), 1.0);
   }
 }
 
 void ILPSolver::blockConnectivity(const std::set<manifest_idx_t> &ms, double targetBlockConnectivity) {
   // m1..mN protect a BasicBlock; m1+m2+..+mN >= min(N, targetBlockConnectivity)
-  auto row = glp_add_rows(lp, 1);
-  glp_set_row_bnds(lp, row, GLP_LO, std::min((double) ms.size(), targetBlockConnectivity), 0.0);
+  auto row = model.addRow();
+  model.setRowBounds(row, BoundType::Lower, std::min((double) ms.size(), targetBlockConnectivity), 0.0);
   std::ostringstream os;
   os << "block_connectivity_" << blockConnectivityCount++;
-  glp_set_row_name(lp, row, os.str().c_str());
+  model.setRowName(row, os.str());
 
   for (auto &idx : ms) {
-    rows.push_back(row);
-    cols.push_back(colsToM.right.at(idx));
-    coeffs.push_back(1.0);
+    model.addCoefficient(row, colsToM.right.at(idx), 1.0);
   }
 }
 
-void ILPSolver::explicitCoverage(llvm::Instruction *I, const std::set<manifest_idx_t> &ms) {
+int ILPSolver::explicitCoverage(const std::set<manifest_idx_t> &ms, size_t weight) {
   std::ostringstream os;
   os << "i" << instructionCount;
 
-  auto col = glp_add_cols(lp, 1);
+  auto col = model.addColumn();
 
-  glp_set_col_name(lp, col, os.str().c_str()); // assigns name m_n to nth column
-  glp_set_col_kind(lp, col, GLP_BV);                      // values are binary
-  glp_set_col_bnds(lp, col, GLP_DB, 0.0, 1.0);            // values are binary
-  glp_set_obj_coef(lp, col, get_obj_coef_explicit(1));
+  model.setColumnName(col, os.str()); // assigns name m_n to nth column
+  model.setColumnKind(col, ColumnKind::Binary); // values are binary
+  model.setColumnBounds(col, BoundType::Double, 0.0, 1.0); // values are binary
+  term(col).role = ilp::ColumnRole::Explicit;
+  term(col).coverage = weight;
 
-  ItoCols.insert({I, col});
-  addModeColumns(col, 0, 1 /*explicit cov of instruction*/, 0, 0, 0, 0);
+  addModeColumns(col, 0, weight /*explicit cov of instructions*/, 0, 0, 0, 0);
 
   // any of m1...mN if c
-  auto orRow = glp_add_rows(lp, 1);
-  glp_set_row_bnds(lp, orRow, GLP_DB, 0.0, std::max(size_t(1), ms.size() - 1));
   os << "_row";
-  glp_set_row_name(lp, orRow, os.str().c_str());
+  anyOf(col, ms, os.str());
+  instructionCount++;
+  return col;
+}
+
+void ILPSolver::anyOf(int col, const std::set<manifest_idx_t> &ms, const std::string &name) {
+  if (composition::support::ILPFormulation == "legacy") {
+    // N * c - m1 - .. - mN in [0, N-1]
+    auto orRow = model.addRow();
+    model.setRowBounds(orRow, BoundType::Double, 0.0, std::max(size_t(1), ms.size() - 1));
+    model.setRowName(orRow, name);
+
+    model.addCoefficient(orRow, col, std::max(size_t(2), ms.size()));
 
-  rows.push_back(orRow);
-  cols.push_back(col);
-  coeffs.push_back(std::max(size_t(2), ms.size()));
+    for (auto m : ms) {
+      model.addCoefficient(orRow, colsToM.right.at(m), -1.0);
+    }
+    return;
+  }
+
+  if (ms.size() == 1) {
+    // c - m1 = 0
+    auto row = model.addRow();
+    model.setRowBounds(row, BoundType::Fixed, 0.0, 0.0);
+    model.setRowName(row, name);
+    model.addCoefficient(row, col, 1.0);
+    model.addCoefficient(row, colsToM.right.at(*ms.begin()), -1.0);
+    return;
+  }
 
+  // c - m1 - .. - mN <= 0
+  auto orRow = model.addRow();
+  model.setRowBounds(orRow, BoundType::Upper, 0.0, 0.0);
+  model.setRowName(orRow, name);
+  model.addCoefficient(orRow, col, 1.0);
   for (auto m : ms) {
-    rows.push_back(orRow);
-    cols.push_back(colsToM.right.at(m));
-    coeffs.push_back(-1.0);
+    model.addCoefficient(orRow, colsToM.right.at(m), -1.0);
+  }
+
+  // c - mj >= 0
+  for (auto m : ms) {
+    auto row = model.addRow();
+    model.setRowBounds(row, BoundType::Lower, 0.0, 0.0);
+    std::ostringstream os;
+    os << name << "_" << m;
+    model.setRowName(row, os.str());
+    model.addCoefficient(row, col, 1.0);
+    model.addCoefficient(row, colsToM.right.at(m), -1.0);
+  }
+}
+
+void ILPSolver::connectivityCoverage(const std::set<manifest_idx_t> &ms, const CoverageGroup &group) {
+  // c counts the accepted manifests covering each instruction of the group: 0 <= c <= min(N, cap); c - m1 - .. - mN <= 0
+  size_t cap = ms.size();
+  if (ILPConnectivityCap > 0) {
+    cap = std::min(cap, static_cast<size_t>(ILPConnectivityCap));
+  }
+
+  std::ostringstream os;
+  os << model.columnName(group.col) << "_connectivity";
+
+  auto col = model.addColumn();
+  model.setColumnName(col, os.str());
+  model.setColumnKind(col, ColumnKind::Integer);
+  model.setColumnBounds(col, BoundType::Double, 0.0, cap);
+  term(col).role = ilp::ColumnRole::Connectivity;
+  term(col).coverage = group.weight;
+
+  auto row = model.addRow();
+  model.setRowBounds(row, BoundType::Upper, 0.0, 0.0);
+  os << "_row";
+  model.setRowName(row, os.str());
+
+  model.addCoefficient(row, col, 1.0);
+  for (auto m : ms) {
+    model.addCoefficient(row, colsToM.right.at(m), -1.0);
+  }
+}
+
+void ILPSolver::addOverheadBudgets(const std::vector<OverheadBudget> &budgets) {
+  for (auto &budget : budgets) {
+    // Costs are block frequencies, the tight formulation scales the row to a largest coefficient of 1
+    double scale = 1.0;
+    if (composition::support::ILPFormulation != "legacy") {
+      for (auto &[mIdx, cost] : budget.costs) {
+        scale = std::max(scale, cost);
+      }
+    }
+
+    // c1 * m1 + .. + cN * mN <= limit
+    auto row = model.addRow();
+    model.setRowBounds(row, BoundType::Upper, 0.0, budget.limit / scale);
+    model.setRowName(row, budget.name);
+
+    for (auto &[mIdx, cost] : budget.costs) {
+      model.addCoefficient(row, colsToM.right.at(mIdx), cost / scale);
+    }
+  }
+}
+
+void ILPSolver::addSymmetryClasses(const std::vector<std::vector<manifest_idx_t>> &classes) {
+  for (auto &cls : classes) {
+    std::vector<int> cols{};
+    for (auto idx : cls) {
+      cols.push_back(colsToM.right.at(idx));
+    }
+    symmetryClasses.push_back(cols);
   }
-  instructionCount++;
 }
 
 void ILPSolver::addUndoDependencies(const std::unordered_map<manifest_idx_t, Manifest *> &manifests) {
   for (auto[idx, m] : manifests) {
+    // Undo instructions in the same coverage group share a column, only one row is needed per group
+    std::set<int> undoCols{};
     for (auto v : m->UndoValues()) {
       if (auto I = llvm::dyn_cast<llvm::Instruction>(v)) {
-        // m1 <=> i1
         auto it = ItoCols.find(I);
-        if (it == ItoCols.end()) {
-          continue;
+        if (it != ItoCols.end()) {
+          undoCols.insert(it->second);
         }
-        auto iCol = it->second;
-        auto mCol = colsToM.right.at(idx);
+      }
+    }
 
-        // m1 <=> i1
-        auto row = glp_add_rows(lp, 1);
-        glp_set_row_bnds(lp, row, GLP_FX, 0.0, 0.0);
+    for (auto iCol : undoCols) {
+      auto mCol = colsToM.right.at(idx);
 
-        std::ostringstream os;
-        os << "undo_m" << idx << "_" << glp_get_col_name(lp, iCol);
-        glp_set_row_name(lp, row, os.str().c_str());
+      // m1 <=> i1
+      auto row = model.addRow();
+      model.setRowBounds(row, BoundType::Fixed, 0.0, 0.0);
 
-        rows.push_back(row);
-        cols.push_back(iCol);
-        coeffs.push_back(-1.0);
+      std::ostringstream os;
+      os << "undo_m" << idx << "_" << model.columnName(iCol);
+      model.setRowName(row, os.str());
 
-        rows.push_back(row);
-        cols.push_back(mCol);
-        coeffs.push_back(1.0);
-      }
+      model.addCoefficient(row, iCol, -1.0);
+
+      model.addCoefficient(row, mCol, 1.0);
     }
   }
 
@@ -10,11 +10,14 @@
 #include <lemon/connectivity.h>
 #include <queue>
 #include <random>
+#include <stack>
+#include <tuple>
 #include <unordered_set>
 #include <vector>
 
 namespace composition::graph {
 using composition::graph::ILPSolver;
+using composition::graph::OverheadBudget;
 using composition::graph::algorithm::AllCycles;
 using composition::graph::constraint::Dependency;
 using composition::graph::constraint::Present;
@@ -30,7 +33,19 @@ using llvm::dyn_cast;
 using composition::support::ILPImplicitBound;
 using composition::support::ILPExplicitBound;
 using composition::support::ILPOverheadBound;
+using composition::support::ILPSizeBound;
 using composition::support::ILPObjective;
+using composition::support::ILPCoverage;
+using composition::support::ILPSweep;
+using composition::support::ILPBreakSymmetry;
+using composition::support::LPMethod;
+using composition::support::LPRounding;
+using composition::support::HotnessLimit;
+using composition::support::HotnessPercentile;
+using composition::support::RandomSeed;
+using composition::support::RandomStarts;
+using composition::support::OverheadModel;
+using composition::support::RefineTime;
 
 ProtectionGraph::ProtectionGraph() {
   vertices = std::make_unique<lemon::ListDigraph::NodeMap<vertex_t>>(LG);
@@ -231,6 +246,35 @@ std::set<std::pair<manifest_idx_t, manifest_idx_t>> ProtectionGraph::vertexConfl
   return conflicts;
 }
 
+std::set<std::set<manifest_idx_t>> ProtectionGraph::variantGroups() {
+  std::map<size_t, std::set<manifest_idx_t>> groups{};
+  for (auto&[mIdx, m] : MANIFESTS) {
+    if (m->variantGroup) {
+      groups[*m->variantGroup].insert(mIdx);
+    }
+  }
+
+  std::set<std::set<manifest_idx_t>> result{};
+  for (auto&[_, ms] : groups) {
+    if (ms.size() > 1) {
+      result.insert(ms);
+    }
+  }
+  return result;
+}
+
+std::set<std::pair<manifest_idx_t, manifest_idx_t>> ProtectionGraph::variantConflicts() {
+  std::set<std::pair<manifest_idx_t, manifest_idx_t>> conflicts{};
+  for (auto &ms : variantGroups()) {
+    for (auto i = ms.begin(), i_end = ms.end(); i != i_end; ++i) {
+      for (auto j = std::next(i, 1); j != i_end; ++j) {
+        conflicts.insert({*i, *j});
+      }
+    }
+  }
+  return conflicts;
+}
+
 std::set<std::pair<manifest_idx_t, manifest_idx_t>> ProtectionGraph::computeDependencies() {
   std::set<std::pair<manifest_idx_t, manifest_idx_t>> dependencies{};
 
@@ -338,6 +382,28 @@ std::map<llvm::Instruction *, std::set<manifest_idx_t>> ProtectionGraph::compute
   return mapping;
 }
 
+std::map<llvm::Instruction *, std::set<manifest_idx_t>> ProtectionGraph::computeBlockCoverage(llvm::Module &M) {
+  std::map<llvm::BasicBlock *, std::set<manifest_idx_t>> blocks{};
+  for (auto&[mIdx, m] : MANIFESTS) {
+    auto covered = m->BlockCoverage();
+    // Manifests without a block protectee cover the blocks of their instructions
+    if (covered.empty()) {
+      covered = Coverage::InstructionsToBasicBlocks(m->Coverage());
+    }
+    for (auto *BB : covered) {
+      blocks[BB].insert(mIdx);
+    }
+  }
+
+  std::map<llvm::Instruction *, std::set<manifest_idx_t>> mapping{};
+  for (auto&[BB, ms] : blocks) {
+    for (auto &I : *BB) {
+      mapping[&I] = ms;
+    }
+  }
+  return mapping;
+}
+
 std::set<std::set<manifest_idx_t>> ProtectionGraph::computeConnectivity(const std::map<llvm::Instruction *,
                                                                                        std::set<manifest_idx_t>> &mapping) {
   std::set<std::set<manifest_idx_t>> result{};
@@ -390,6 +456,107 @@ size_t manifestHotnessProtectee(Manifest *m, const std::unordered_map<llvm::Basi
   return maxHotnessOfInstructions(instr, BFI);
 }
 
+/**
+ * Cost of keeping a manifest, shared by all conflict handling strategies. The multiplier of the protection type scales
+ * the whole cost, so cheap protections stay cheap in hot code. The dynamic model measures the cost in estimated extra
+ * cycles.
+ */
+double manifestCost(const ManifestStats &s, const metric::Weights &weights) {
+  if (OverheadModel == "dynamic") {
+    return s.dynamicOverhead * s.protectionCost;
+  }
+  return (weights.basicBlockProfileCount * s.normalizedHotness + (1.0 - s.normalizedHotnessProtectee)) *
+      s.protectionCost;
+}
+
+std::map<manifest_idx_t, ManifestStats> ProtectionGraph::computeManifestStats(
+    const std::unordered_map<llvm::BasicBlock *, uint64_t> &BFI, std::pair<size_t, size_t> implicitCBounds,
+    const metric::Weights &weights) {
+  const std::string &model = OverheadModel;
+  if (model != "hotness" && model != "dynamic") {
+    llvm::report_fatal_error(llvm::Twine("Unknown overhead model '") + model + "'");
+  }
+  std::map<manifest_idx_t, ManifestStats> mStats{};
+  std::pair<size_t, size_t> explicitCBounds{SIZE_MAX, 0};
+  std::pair<size_t, size_t> hotnessBounds{SIZE_MAX, 0};
+  std::pair<size_t, size_t> hotnessProtecteeBounds{SIZE_MAX, 0};
+
+  for (auto&[mIdx, m] : MANIFESTS) {
+    mStats[mIdx].explicitC = m->Coverage().size();
+    mStats[mIdx].hotness = manifestHotness(m, BFI);
+    mStats[mIdx].hotnessProtectee = manifestHotnessProtectee(m, BFI);
+    auto undoInstructions = Coverage::ValuesToInstructions(m->UndoValues());
+    mStats[mIdx].codeSize = undoInstructions.size();
+    mStats[mIdx].dynamicOverhead = metric::Performance::dynamicCost(undoInstructions, BFI, weights.callCosts);
+    if (auto cost = weights.protectionCosts.find(m->name); cost != weights.protectionCosts.end()) {
+      mStats[mIdx].protectionCost = cost->second;
+    }
+
+    explicitCBounds.first = std::min(explicitCBounds.first, mStats[mIdx].explicitC);
+    explicitCBounds.second = std::max(explicitCBounds.second, mStats[mIdx].explicitC);
+
+    hotnessBounds.first = std::min(hotnessBounds.first, mStats[mIdx].hotness);
+    hotnessBounds.second = std::max(hotnessBounds.second, mStats[mIdx].hotness);
+
+    hotnessProtecteeBounds.first = std::min(hotnessProtecteeBounds.first, mStats[mIdx].hotnessProtectee);
+    hotnessProtecteeBounds.second = std::max(hotnessProtecteeBounds.second, mStats[mIdx].hotnessProtectee);
+  }
+
+  for (auto&[idx, s] : mStats) {
+    s.normalize(explicitCBounds, implicitCBounds, hotnessBounds, hotnessProtecteeBounds);
+  }
+  return mStats;
+}
+
+std::set<Manifest *> ProtectionGraph::hotManifests(const std::unordered_map<llvm::BasicBlock *, uint64_t> &BFI) {
+  uint64_t threshold = UINT64_MAX;
+  if (HotnessLimit > 0) {
+    threshold = HotnessLimit;
+  }
+  if (HotnessPercentile > 0 && !BFI.empty()) {
+    std::vector<uint64_t> frequencies{};
+    for (auto&[BB, frequency] : BFI) {
+      frequencies.push_back(frequency);
+    }
+    std::sort(frequencies.begin(), frequencies.end());
+    auto rank = static_cast<size_t>(HotnessPercentile / 100.0 * static_cast<double>(frequencies.size()));
+    threshold = std::min(threshold, frequencies[std::min(rank, frequencies.size() - 1)]);
+  }
+  if (threshold == UINT64_MAX) {
+    return {};
+  }
+
+  std::stack<manifest_idx_t> s{};
+  for (auto&[mIdx, m] : MANIFESTS) {
+    if (manifestHotness(m, BFI) > threshold) {
+      s.push(mIdx);
+    }
+  }
+
+  // Dependents are undone together with the hot manifests
+  std::set<manifest_idx_t> hot{};
+  while (!s.empty()) {
+    manifest_idx_t mIdx = s.top();
+    s.pop();
+    if (!hot.insert(mIdx).second) {
+      continue;
+    }
+    if (auto found = DependencyUndo.right.find(mIdx); found != DependencyUndo.right.end()) {
+      for (auto d : found->second) {
+        s.push(d);
+      }
+    }
+  }
+
+  std::set<Manifest *> result{};
+  for (auto mIdx : hot) {
+    result.insert(MANIFESTS.at(mIdx));
+  }
+  dbgs() << "Hotness threshold: " << threshold << " hot manifests: " << result.size() << "/" << MANIFESTS.size()
+         << "\n";
+  return result;
+}
+
 inline double round(double val) {
   if (val < 0)
     return ceil(val - 0.5);
@@ -448,26 +615,36 @@ std::set<Manifest *> ProtectionGraph::randomConflictHandling(llvm::Module &M) {
     cycles = pg.computeCycles();
 
     Profiler detectingProfiler{};
-    conflicts = vertexConflicts();
+    conflicts = pg.vertexConflicts();
+    conflicts.merge(pg.variantConflicts());
     cStats.timeConflictDetection += detectingProfiler.stop();
 
     resolvingProfiler.reset();
-    std::set<manifest_idx_t> flatConflicts{};
-
+    std::vector<std::vector<manifest_idx_t>> hits{};
     for (auto &c : cycles) {
       ++cycleCount;
-      for (auto &idx : c) {
-        flatConflicts.insert(idx);
-      }
+      hits.emplace_back(c.begin(), c.end());
     }
     for (auto &c : conflicts) {
-      flatConflicts.insert(c.first);
-      flatConflicts.insert(c.second);
       ++conflictCount;
+      hits.push_back({c.first, c.second});
+    }
+
+    // Remove a random hitting set of all known conflicts and cycles at once, another round is only needed for cycles
+    // exposed by the removal. A set is already hit if one of its manifests was removed, possibly by an undo cascade.
+    std::shuffle(hits.begin(), hits.end(), RNG);
+    size_t removed = 0;
+    for (auto &hit : hits) {
+      auto isRemoved = [this](manifest_idx_t idx) { return MANIFESTS.find(idx) == MANIFESTS.end(); };
+      if (std::any_of(hit.begin(), hit.end(), isRemoved)) {
+        continue;
+      }
+      removeManifest(*select_randomly(hit.begin(), hit.end(), RNG));
+      ++removed;
     }
-    if (!flatConflicts.empty()) {
-      auto selected = *select_randomly(flatConflicts.begin(), flatConflicts.end());
-      removeManifest(selected);
+    if (removed > 0) {
+      dbgs() << "Removed " << removed << " manifests hitting " << cycles.size() << " cycles and " << conflicts.size()
+             << " conflicts\n";
     }
 
     cStats.timeConflictResolving += resolvingProfiler.stop();
@@ -479,6 +656,183 @@ std::set<Manifest *> ProtectionGraph::randomConflictHandling(llvm::Module &M) {
   return accepted;
 }
 
+Greedy<manifest_idx_t> ProtectionGraph::buildResolver(llvm::Module &M,
+                                                     const std::unordered_map<llvm::BasicBlock *, uint64_t> &BFI,
+                                                     const metric::Weights &weights) {
+  Profiler detectingProfiler{};
+  auto conflicts = vertexConflicts();
+  conflicts.merge(variantConflicts());
+  cStats.timeConflictDetection += detectingProfiler.stop();
+  auto exactCoverage = computeExactCoverage(M);
+  auto mStats = computeManifestStats(BFI, {0, 0}, weights);
+
+  Greedy<manifest_idx_t> greedy{};
+  greedy.setCoverageWeights(weights.explicitInstructionCoverage, weights.implicitInstructionCoverage);
+  for (auto&[mIdx, m] : MANIFESTS) {
+    greedy.addManifest(mIdx, manifestCost(mStats[mIdx], weights));
+  }
+  for (auto&[mIdx, dependents] : DependencyUndo.right) {
+    for (auto d : dependents) {
+      greedy.addDependent(mIdx, d);
+    }
+  }
+  for (auto&[mIdx, protectors] : ManifestProtection.left) {
+    for (auto p : protectors) {
+      greedy.addProtection(mIdx, p);
+    }
+  }
+  for (auto &c : conflicts) {
+    greedy.addConflict(c.first, c.second);
+  }
+
+  // Arcs carrying a constraint of no manifest (hierarchy, shadow connections) stay in the graph regardless of the
+  // accepted manifests
+  for (lemon::ListDigraph::ArcIt a(LG); a != lemon::INVALID; ++a) {
+    auto arc = greedy.addArc(static_cast<size_t>(LG.id(LG.source(a))), static_cast<size_t>(LG.id(LG.target(a))));
+    const edge_t &e = (*edges)[a];
+    std::set<manifest_idx_t> owners{};
+    bool owned = !e.constraints.empty();
+    for (auto&[cIdx, c] : e.constraints) {
+      if (auto mFound = MANIFESTS_CONSTRAINTS.right.find(cIdx); mFound != MANIFESTS_CONSTRAINTS.right.end()) {
+        owners.insert(mFound->second);
+      } else {
+        owned = false;
+      }
+    }
+    if (owned) {
+      for (auto mIdx : owners) {
+        greedy.addArcOwner(arc, mIdx);
+      }
+    }
+  }
+
+  // Instructions covered by the same manifests are accounted for once
+  std::map<std::set<manifest_idx_t>, size_t> coverageGroups{};
+  for (auto&[I, ms] : exactCoverage) {
+    ++coverageGroups[ms];
+  }
+  for (auto&[ms, weight] : coverageGroups) {
+    greedy.addCoverage(ms, weight);
+  }
+  return greedy;
+}
+
+std::set<Manifest *> ProtectionGraph::greedyConflictHandling(llvm::Module &M,
+                                                             const std::unordered_map<llvm::BasicBlock *,
+                                                                                      uint64_t> &BFI,
+                                                             const metric::Weights &weights) {
+  auto greedy = buildResolver(M, BFI, weights);
+
+  Profiler resolvingProfiler{};
+  Greedy<manifest_idx_t>::Bounds bounds{};
+  bounds.overhead = ILPOverheadBound;
+  bounds.explicitC = static_cast<size_t>(std::max(0, ILPExplicitBound.getValue()));
+  bounds.implicitC = static_cast<size_t>(std::max(0, ILPImplicitBound.getValue()));
+  auto result = greedy.run(bounds);
+  cStats.timeConflictResolving += resolvingProfiler.stop();
+
+  dbgs() << "Greedy results. accepted: " << result.accepted.size() << "/" << MANIFESTS.size()
+         << " overhead: " << result.overhead << " explicit instruction coverage: " << result.explicitC
+         << " implicit instruction coverage: " << result.implicitC << "\n";
+  if (!result.boundsMet) {
+    dbgs() << "Greedy could not meet the requested bounds (overhead: " << bounds.overhead
+           << " explicit: " << bounds.explicitC << " implicit: " << bounds.implicitC << ")\n";
+  }
+
+  cStats.cycles = result.cycles;
+  cStats.conflicts = result.conflicts;
+
+  std::set<Manifest *> accepted{};
+  for (auto mIdx : result.accepted) {
+    accepted.insert(MANIFESTS.at(mIdx));
+  }
+  return accepted;
+}
+
+std::set<Manifest *> ProtectionGraph::multiStartConflictHandling(llvm::Module &M,
+                                                                 const std::unordered_map<llvm::BasicBlock *,
+                                                                                          uint64_t> &BFI,
+                                                                 const metric::Weights &weights) {
+  auto resolver = buildResolver(M, BFI, weights);
+
+  Profiler resolvingProfiler{};
+  int starts = std::max(1, RandomStarts.getValue());
+  // Seeds wrap around like the unsigned -cf-random-seed, so every logged seed can be passed back
+  unsigned seed = RandomSeed.getNumOccurrences() > 0 ? RandomSeed.getValue() : std::random_device{}();
+
+  // Every start resolves its own copy of the resolver, the seed of a start only depends on its number
+  std::vector<Greedy<manifest_idx_t>::Result> results(static_cast<size_t>(starts));
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < starts; ++i) {
+    auto run = resolver;
+    run.randomize(seed + static_cast<unsigned>(i));
+    results[i] = run.run({});
+  }
+
+  // Weighted coverage per estimated overhead, ties go to the lower seed
+  auto score = [&weights](const Greedy<manifest_idx_t>::Result &r) {
+    return (weights.explicitInstructionCoverage * static_cast<double>(r.explicitC) +
+        weights.implicitInstructionCoverage * static_cast<double>(r.implicitC)) / (1.0 + r.overhead);
+  };
+  size_t best = 0;
+  for (size_t i = 1; i < results.size(); ++i) {
+    if (score(results[i]) > score(results[best])) {
+      best = i;
+    }
+  }
+  cStats.timeConflictResolving += resolvingProfiler.stop();
+
+  auto &result = results[best];
+  unsigned bestSeed = seed + static_cast<unsigned>(best);
+  dbgs() << "Random multi-start. best of " << starts << " runs with seed " << bestSeed
+         << " (reproduce with -cf-random-seed=" << bestSeed << " -cf-random-starts=1) accepted: "
+         << result.accepted.size() << "/" << MANIFESTS.size() << " overhead: " << result.overhead
+         << " explicit instruction coverage: " << result.explicitC
+         << " implicit instruction coverage: " << result.implicitC << "\n";
+
+  cStats.cycles = result.cycles;
+  cStats.conflicts = result.conflicts;
+
+  std::set<Manifest *> accepted{};
+  for (auto mIdx : result.accepted) {
+    accepted.insert(MANIFESTS.at(mIdx));
+  }
+  return accepted;
+}
+
+std::set<Manifest *> ProtectionGraph::refineSelection(llvm::Module &M,
+                                                      const std::unordered_map<llvm::BasicBlock *, uint64_t> &BFI,
+                                                      const metric::Weights &weights,
+                                                      const std::set<Manifest *> &accepted) {
+  auto resolver = buildResolver(M, BFI, weights);
+  for (auto&[mIdx, m] : MANIFESTS) {
+    if (accepted.find(m) == accepted.end()) {
+      resolver.exclude(mIdx);
+    }
+  }
+  if (RandomSeed.getNumOccurrences() > 0) {
+    resolver.randomize(RandomSeed.getValue());
+  }
+
+  Profiler refiningProfiler{};
+  Greedy<manifest_idx_t>::Bounds bounds{};
+  bounds.overhead = ILPOverheadBound;
+  bounds.explicitC = static_cast<size_t>(std::max(0, ILPExplicitBound.getValue()));
+  bounds.implicitC = static_cast<size_t>(std::max(0, ILPImplicitBound.getValue()));
+  auto result = resolver.refine(bounds, RefineTime);
+  cStats.timeConflictResolving += refiningProfiler.stop();
+
+  dbgs() << "Refinement results. moves: " << result.moves << " accepted: " << result.accepted.size() << "/"
+         << MANIFESTS.size() << " overhead: " << result.overhead << " explicit instruction coverage: "
+         << result.explicitC << " implicit instruction coverage: " << result.implicitC << "\n";
+
+  std::set<Manifest *> refined{};
+  for (auto mIdx : result.accepted) {
+    refined.insert(MANIFESTS.at(mIdx));
+  }
+  return refined;
+}
+
 std::vector<std::pair<manifest_idx_t,
                       std::pair<uint64_t,
                                 std::vector<manifest_idx_t>>>> calculateNOfs(std::unordered_map<manifest_idx_t,
@@ -505,55 +859,121 @@ std::vector<std::pair<manifest_idx_t,
   return result;
 }
 
-std::set<Manifest *> ProtectionGraph::ilpConflictHandling(llvm::Module &M,
-                                                          const std::unordered_map<llvm::BasicBlock *, uint64_t> &BFI,
-                                                          size_t totalInstructions) {
-  // TODO: cStats.stats is not set at this point ----
-  size_t TotalInstructions = cStats.stats.numberOfAllInstructions;
-  llvm::dbgs() << "Total instruction:" << totalInstructions << "\n";
-  llvm::dbgs() << "ILPImplicitBound:" << ILPImplicitBound << "\n";
-  //llvm::dbgs() << "PercentageImplicitBound:" << ILPPercentageImplicitBound << "\n";
-  //size_t implicitCoverageToInstruction = totalInstructions * ((double) ILPPercentageImplicitBound / 100.00);
-  //llvm::dbgs() << "Requested Implicit coverage of (instruction) " << implicitCoverageToInstruction << "\n";
+std::vector<OverheadBudget> calculateOverheadBudgets(const std::unordered_map<manifest_idx_t, Manifest *> &manifests,
+                                                     const std::unordered_map<llvm::BasicBlock *, uint64_t> &BFI,
+                                                     const metric::Weights &weights) {
+  std::vector<OverheadBudget> result{};
+  if (weights.functionOverheadBudget <= 0 && weights.hotRegionOverheadBudget <= 0) {
+    return result;
+  }
 
-  Profiler detectingProfiler{};
-  auto conflicts = vertexConflicts();
-  auto dependencies = computeDependencies();
-  cStats.timeConflictDetection += detectingProfiler.stop();
-  auto cycles = computeCycles();
-  auto exactCoverage = computeExactCoverage(M);
-  auto connectivities = computeConnectivity(exactCoverage);
-  auto blockConnectivities = computeBlockConnectivity(M);
+  // Blocks at or above the percentile are hot
+  uint64_t hotThreshold = UINT64_MAX;
+  if (weights.hotRegionOverheadBudget > 0 && !BFI.empty()) {
+    std::vector<uint64_t> frequencies{};
+    for (auto&[BB, frequency] : BFI) {
+      frequencies.push_back(frequency);
+    }
+    std::sort(frequencies.begin(), frequencies.end());
+    auto rank = static_cast<size_t>(weights.hotRegionPercentile / 100.0 * static_cast<double>(frequencies.size()));
+    hotThreshold = frequencies[std::min(rank, frequencies.size() - 1)];
+  }
 
-  // Sanity check
-  assert(Performance::hasProfiling(M));
+  // The estimated dynamic cost of a block is its number of instructions times its frequency
+  std::map<llvm::Function *, double> functionCost{};
+  std::map<llvm::Function *, double> hotCost{};
+  for (auto&[BB, frequency] : BFI) {
+    double cost = static_cast<double>(BB->size()) * static_cast<double>(frequency);
+    functionCost[BB->getParent()] += cost;
+    if (frequency >= hotThreshold) {
+      hotCost[BB->getParent()] += cost;
+    }
+  }
 
-  // Prepare manifest statistics
-  std::map<manifest_idx_t, ManifestStats> eStats{};
+  // Manifests add the instructions they would undo
+  std::map<llvm::Function *, std::map<manifest_idx_t, double>> added{};
+  std::map<llvm::Function *, std::map<manifest_idx_t, double>> hotAdded{};
+  for (auto&[mIdx, m] : manifests) {
+    for (auto *I : Coverage::ValuesToInstructions(m->UndoValues())) {
+      auto found = BFI.find(I->getParent());
+      if (found == BFI.end()) {
+        continue;
+      }
+      llvm::Function *F = I->getFunction();
+      added[F][mIdx] += static_cast<double>(found->second);
+      if (found->second >= hotThreshold) {
+        hotAdded[F][mIdx] += static_cast<double>(found->second);
+      }
+    }
+  }
 
-  std::map<manifest_idx_t, ManifestStats> mStats{};
-  std::map<manifest_idx_t, std::set<llvm::Instruction *>> coverageCache{};
-  std::pair<size_t, size_t> explicitCBounds{SIZE_MAX, 0};
-  std::pair<size_t, size_t> implicitCBounds{SIZE_MAX, 0};
-  std::pair<size_t, size_t> hotnessBounds{SIZE_MAX, 0};
-  std::pair<size_t, size_t> hotnessProtecteeBounds{SIZE_MAX, 0};
+  if (weights.functionOverheadBudget > 0) {
+    for (auto&[F, costs] : added) {
+      result.push_back({"budget_" + F->getName().str(), weights.functionOverheadBudget * functionCost[F], costs});
+    }
+  }
+  if (weights.hotRegionOverheadBudget > 0) {
+    for (auto&[F, costs] : hotAdded) {
+      result.push_back({"hot_budget_" + F->getName().str(), weights.hotRegionOverheadBudget * hotCost[F], costs});
+    }
+  }
+  dbgs() << "Overhead budgets: " << result.size() << "\n";
+  return result;
+}
 
-  for (auto&[mIdx, m] : MANIFESTS) {
-    auto cov = m->Coverage();
-    coverageCache.insert({mIdx, cov});
-    mStats[mIdx].explicitC = cov.size();
-    mStats[mIdx].hotness = manifestHotness(m, BFI);
-    mStats[mIdx].hotnessProtectee = manifestHotnessProtectee(m, BFI);
+std::vector<OverheadBudget> calculateCodeSizeBudgets(const std::unordered_map<manifest_idx_t, Manifest *> &manifests,
+                                                     const std::map<manifest_idx_t, ManifestStats> &mStats,
+                                                     const metric::Weights &weights) {
+  std::vector<OverheadBudget> result{};
+  if (ILPSizeBound > 0) {
+    std::map<manifest_idx_t, double> costs{};
+    for (auto&[mIdx, s] : mStats) {
+      costs[mIdx] = static_cast<double>(s.codeSize);
+    }
+    result.push_back({"size_budget", static_cast<double>(ILPSizeBound), costs});
+  }
 
-    explicitCBounds.first = std::min(explicitCBounds.first, mStats[mIdx].explicitC);
-    explicitCBounds.second = std::max(explicitCBounds.second, mStats[mIdx].explicitC);
+  if (weights.functionCodeSizeBudget > 0) {
+    // Manifests add the instructions they would undo to the functions containing them
+    std::map<llvm::Function *, std::map<manifest_idx_t, double>> added{};
+    for (auto&[mIdx, m] : manifests) {
+      for (auto *I : Coverage::ValuesToInstructions(m->UndoValues())) {
+        added[I->getFunction()][mIdx] += 1.0;
+      }
+    }
+    for (auto&[F, costs] : added) {
+      size_t size = 0;
+      for (auto &BB : *F) {
+        size += BB.size();
+      }
+      result.push_back({"size_budget_" + F->getName().str(),
+                        weights.functionCodeSizeBudget * static_cast<double>(size), costs});
+    }
+  }
+  dbgs() << "Code size budgets: " << result.size() << "\n";
+  return result;
+}
 
-    hotnessBounds.first = std::min(hotnessBounds.first, mStats[mIdx].hotness);
-    hotnessBounds.second = std::max(hotnessBounds.second, mStats[mIdx].hotness);
+ProtectionGraph::ILPInput ProtectionGraph::prepareILP(llvm::Module &M,
+                                                      const std::unordered_map<llvm::BasicBlock *, uint64_t> &BFI,
+                                                      const metric::Weights &weights) {
+  ILPInput input{};
 
-    hotnessProtecteeBounds.first = std::min(hotnessProtecteeBounds.first, mStats[mIdx].hotnessProtectee);
-    hotnessProtecteeBounds.second = std::max(hotnessProtecteeBounds.second, mStats[mIdx].hotnessProtectee);
+  Profiler detectingProfiler{};
+  input.conflicts = vertexConflicts();
+  input.dependencies = computeDependencies();
+  input.variants = variantGroups();
+  cStats.timeConflictDetection += detectingProfiler.stop();
+  input.cycles = computeCycles();
+  const std::string &granularity = ILPCoverage;
+  if (granularity != "instruction" && granularity != "block") {
+    llvm::report_fatal_error(llvm::Twine("Unknown ILP coverage granularity '") + granularity + "'");
   }
+  // The block approximation only shapes the model, the stats collected after patching report the exact coverage
+  input.exactCoverage = granularity == "block" ? computeBlockCoverage(M) : computeExactCoverage(M);
+  input.connectivities = computeConnectivity(input.exactCoverage);
+  input.blockConnectivities = computeBlockConnectivity(M);
+
   std::map<manifest_idx_t /*protected manifest*/, std::pair<std::set<manifest_idx_t> /*edges*/, unsigned long>>
       duplicateEdgesOnManifest{};
   metric::Stats s{};
@@ -561,47 +981,169 @@ std::set<Manifest *> ProtectionGraph::ilpConflictHandling(llvm::Module &M,
   //                       unsigned long /*coverage*/>>
   auto implicitCov = s.implictInstructionsPerEdge(ManifestProtection, MANIFESTS, &duplicateEdgesOnManifest);
 
-  std::unordered_map<manifest_idx_t, std::set<manifest_idx_t>> implicitManifestEdges{};
   for (auto[e, mPair, c] : implicitCov) {
-    implicitManifestEdges[mPair.second].insert(mPair.first);
+    input.implicitManifestEdges[mPair.second].insert(mPair.first);
   }
 
+  std::pair<size_t, size_t> implicitCBounds{SIZE_MAX, 0};
   for (auto[edgeIndex, manifestPair, coverage] : implicitCov) {
-    eStats[edgeIndex].implicitC = coverage;
     implicitCBounds.first = std::min(implicitCBounds.first, coverage);
     implicitCBounds.second = std::max(implicitCBounds.second, coverage);
   }
 
-  for (auto&[idx, s] : mStats) {
-    s.normalize(explicitCBounds, implicitCBounds, hotnessBounds, hotnessProtecteeBounds);
+  // Prepare manifest statistics
+  input.mStats = computeManifestStats(BFI, implicitCBounds, weights);
+
+  input.nOfs = calculateNOfs(MANIFESTS);
+  input.budgets = calculateOverheadBudgets(MANIFESTS, BFI, weights);
+  auto sizeBudgets = calculateCodeSizeBudgets(MANIFESTS, input.mStats, weights);
+  input.budgets.insert(input.budgets.end(), sizeBudgets.begin(), sizeBudgets.end());
+  if (ILPBreakSymmetry) {
+    input.symmetryClasses = symmetryClasses(input);
+  }
+  return input;
+}
+
+namespace {
+/**
+ * Everything the ILP rows of a manifest depend on, manifests with equal keys only differ by their column
+ */
+struct SymmetryKey {
+  std::string name{};
+  std::tuple<size_t, size_t, size_t, size_t, size_t, double, double> stats{};
+  std::set<llvm::Instruction *> coverage{};
+  std::set<std::set<manifest_idx_t>> undoGroups{};
+  std::set<manifest_idx_t> conflicts{};
+  std::set<manifest_idx_t> dependencies{};
+  std::set<manifest_idx_t> dependents{};
+  std::set<manifest_idx_t> protectors{};
+  std::set<manifest_idx_t> protectees{};
+  std::set<std::pair<size_t, double>> budgets{};
+
+  bool operator<(const SymmetryKey &other) const {
+    return std::tie(name, stats, coverage, undoGroups, conflicts, dependencies, dependents, protectors, protectees,
+                    budgets) < std::tie(other.name, other.stats, other.coverage, other.undoGroups, other.conflicts,
+                                        other.dependencies, other.dependents, other.protectors, other.protectees,
+                                        other.budgets);
+  }
+};
+} // namespace
+
+std::vector<std::vector<manifest_idx_t>> ProtectionGraph::symmetryClasses(const ILPInput &input) {
+  // Rows over a subset of manifests tell members apart
+  std::set<manifest_idx_t> excluded{};
+  for (auto *groups : {&input.variants, &input.cycles}) {
+    for (auto &group : *groups) {
+      excluded.insert(group.begin(), group.end());
+    }
+  }
+  for (auto &[idx, nOf] : input.nOfs) {
+    excluded.insert(idx);
+    excluded.insert(nOf.second.begin(), nOf.second.end());
+  }
+
+  std::unordered_map<manifest_idx_t, SymmetryKey> keys{};
+  for (auto &[I, manifests] : input.exactCoverage) {
+    for (auto idx : manifests) {
+      keys[idx].coverage.insert(I);
+    }
+  }
+  for (auto &[first, second] : input.conflicts) {
+    keys[first].conflicts.insert(second);
+    keys[second].conflicts.insert(first);
+  }
+  for (auto &[first, second] : input.dependencies) {
+    keys[first].dependencies.insert(second);
+    keys[second].dependents.insert(first);
+  }
+  for (auto &[protectee, protectors] : input.implicitManifestEdges) {
+    keys[protectee].protectors.insert(protectors.begin(), protectors.end());
+    for (auto idx : protectors) {
+      keys[idx].protectees.insert(protectee);
+    }
+  }
+  for (size_t b = 0; b < input.budgets.size(); ++b) {
+    for (auto &[idx, cost] : input.budgets[b].costs) {
+      keys[idx].budgets.emplace(b, cost);
+    }
   }
 
-  auto nOfs = calculateNOfs(MANIFESTS);
+  std::map<SymmetryKey, std::vector<manifest_idx_t>> classes{};
+  for (auto &[idx, m] : MANIFESTS) {
+    if (excluded.find(idx) != excluded.end()) {
+      continue;
+    }
+    auto &key = keys[idx];
+    key.name = m->name;
+    auto &s = input.mStats.at(idx);
+    key.stats = {s.explicitC, s.implicitC, s.hotness, s.hotnessProtectee, s.codeSize, s.protectionCost,
+                 s.dynamicOverhead};
+    for (auto v : m->UndoValues()) {
+      if (auto I = llvm::dyn_cast<llvm::Instruction>(v)) {
+        auto it = input.exactCoverage.find(I);
+        if (it != input.exactCoverage.end()) {
+          key.undoGroups.insert(it->second);
+        }
+      }
+    }
+    classes[key].push_back(idx);
+  }
+
+  std::vector<std::vector<manifest_idx_t>> result{};
+  size_t members = 0;
+  for (auto &[key, cls] : classes) {
+    if (cls.size() > 1) {
+      std::sort(cls.begin(), cls.end());
+      members += cls.size();
+      result.push_back(cls);
+    }
+  }
+  dbgs() << "Symmetry classes: " << result.size() << " with " << members << " manifests\n";
+  return result;
+}
+
+void ProtectionGraph::populateILP(ILPSolver &solver, const ILPInput &input, const metric::Weights &weights) {
+  solver.init(ILPObjective, ILPOverheadBound, ILPExplicitBound, ILPImplicitBound, 0, 0);
+  solver.setCostFunction([&weights](ManifestStats s) { return manifestCost(s, weights); });
+  solver.setWeights(weights);
+  solver.addManifests(MANIFESTS, input.mStats);
+  solver.addSymmetryClasses(input.symmetryClasses);
+  solver.addDependencies(input.dependencies);
+  solver.addConflicts(input.conflicts);
+  solver.addCycles(input.cycles);
+  solver.addVariantGroups(input.variants);
+  solver.addConnectivity(input.connectivities);
+  solver.addBlockConnectivity(input.blockConnectivities);
+  solver.addExplicitCoverages(input.exactCoverage);
+  //solver.addImplicitCoverage(implicitCov, duplicateEdgesOnManifest);
+  solver.addNewImplicitCoverage(input.implicitManifestEdges);
+  solver.addNOfDependencies(input.nOfs);
+  solver.addOverheadBudgets(input.budgets);
+
+  // Must come after explicit coverage is set
+  solver.addUndoDependencies(MANIFESTS);
+}
+
+std::set<Manifest *> ProtectionGraph::ilpConflictHandling(llvm::Module &M,
+                                                          const std::unordered_map<llvm::BasicBlock *, uint64_t> &BFI,
+                                                          size_t totalInstructions,
+                                                          const metric::Weights &weights) {
+  // TODO: cStats.stats is not set at this point ----
+  size_t TotalInstructions = cStats.stats.numberOfAllInstructions;
+  llvm::dbgs() << "Total instruction:" << totalInstructions << "\n";
+  llvm::dbgs() << "ILPImplicitBound:" << ILPImplicitBound << "\n";
+  //llvm::dbgs() << "PercentageImplicitBound:" << ILPPercentageImplicitBound << "\n";
+  //size_t implicitCoverageToInstruction = totalInstructions * ((double) ILPPercentageImplicitBound / 100.00);
+  //llvm::dbgs() << "Requested Implicit coverage of (instruction) " << implicitCoverageToInstruction << "\n";
+
+  auto input = prepareILP(M, BFI, weights);
 
   Profiler resolvingProfiler{};
 
-  auto costFunction = [](ManifestStats s) -> double {
-    return 1.0 * s.normalizedHotness + (1.0 - s.normalizedHotnessProtectee);
-  };
   do {
     ILPSolver solver{};
-    solver.init(ILPObjective, ILPOverheadBound, ILPExplicitBound, ILPImplicitBound, 0, 0);
-    solver.setCostFunction(costFunction);
-    solver.addManifests(MANIFESTS, mStats);
-    solver.addDependencies(dependencies);
-    solver.addConflicts(conflicts);
-    solver.addCycles(cycles);
-    solver.addConnectivity(connectivities);
-    solver.addBlockConnectivity(blockConnectivities);
-    solver.addExplicitCoverages(exactCoverage);
-    //solver.addImplicitCoverage(implicitCov, duplicateEdgesOnManifest);
-    solver.addNewImplicitCoverage(exactCoverage, implicitManifestEdges);
-    solver.addNOfDependencies(nOfs);
-
-    // Must come after explicit coverage is set
-    solver.addUndoDependencies(MANIFESTS);
+    populateILP(solver, input, weights);
     auto[acceptedIndices, acceptedEdges] = solver.run();
-    solver.destroy();
 
     std::set<Manifest *> accepted{};
     for (auto &mIdx : acceptedIndices) {
@@ -618,18 +1160,81 @@ std::set<Manifest *> ProtectionGraph::ilpConflictHandling(llvm::Module &M,
     pg.connectShadowNodes();
     auto newCycles = pg.computeCycles();
     if (!newCycles.empty()) {
+      solver.destroy();
       for (auto &c : newCycles) {
-        cycles.insert(c);
+        input.cycles.insert(c);
       }
     } else {
-      cStats.cycles = cycles.size();
-      cStats.conflicts = conflicts.size();
+      // The sweep only describes the final model, cycle repair iterations would overwrite its table
+      if (!ILPSweep.empty()) {
+        solver.sweep();
+      }
+      solver.destroy();
+      cStats.cycles = input.cycles.size();
+      cStats.conflicts = input.conflicts.size();
       cStats.timeConflictResolving += resolvingProfiler.stop();
       return accepted;
     }
   } while (true);
 }
 
+std::set<Manifest *> ProtectionGraph::lpConflictHandling(llvm::Module &M,
+                                                         const std::unordered_map<llvm::BasicBlock *, uint64_t> &BFI,
+                                                         const metric::Weights &weights) {
+  auto input = prepareILP(M, BFI, weights);
+  auto resolver = buildResolver(M, BFI, weights);
+
+  Profiler resolvingProfiler{};
+  ILPSolver solver{};
+  populateILP(solver, input, weights);
+  auto[values, bound] = solver.relax(LPMethod == "interior" ? ilp::LPMethod::Interior : ilp::LPMethod::Simplex);
+  solver.destroy();
+
+  // Rounding only drops manifests, the resolver repairs the conflicts, cycles and dependencies left over
+  unsigned seed = RandomSeed.getNumOccurrences() > 0 ? RandomSeed.getValue() : std::random_device{}();
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> dis(0.0, 1.0);
+  size_t fractional = 0;
+  size_t dropped = 0;
+  for (auto&[mIdx, value] : values) {
+    if (value > 1e-6 && value < 1 - 1e-6) {
+      ++fractional;
+    }
+    double threshold = LPRounding == "random" ? dis(rng) : 0.5;
+    if (value < threshold) {
+      resolver.exclude(mIdx);
+      ++dropped;
+    }
+  }
+
+  Greedy<manifest_idx_t>::Bounds bounds{};
+  bounds.overhead = ILPOverheadBound;
+  bounds.explicitC = static_cast<size_t>(std::max(0, ILPExplicitBound.getValue()));
+  bounds.implicitC = static_cast<size_t>(std::max(0, ILPImplicitBound.getValue()));
+  auto result = resolver.run(bounds);
+  cStats.timeConflictResolving += resolvingProfiler.stop();
+
+  dbgs() << "LP relaxation bound (" << ILPObjective << "): " << bound << " fractional manifests: " << fractional
+         << "/" << values.size() << " rounded down: " << dropped << " (" << LPRounding << ", seed " << seed << ")\n";
+  dbgs() << "LP rounding results. accepted: " << result.accepted.size() << "/" << MANIFESTS.size()
+         << " overhead: " << result.overhead << " explicit instruction coverage: " << result.explicitC
+         << " implicit instruction coverage: " << result.implicitC << " repaired conflicts: " << result.conflicts
+         << " cycles: " << result.cycles << "\n";
+  if (!result.boundsMet) {
+    dbgs() << "LP rounding could not meet the requested bounds (overhead: " << bounds.overhead
+           << " explicit: " << bounds.explicitC << " implicit: " << bounds.implicitC << ")\n";
+  }
+
+  cStats.cycles = result.cycles;
+  cStats.conflicts = result.conflicts;
+
+  std::set<Manifest *> accepted{};
+  for (auto mIdx : result.accepted) {
+    accepted.insert(MANIFESTS.at(mIdx));
+  }
+  return accepted;
+}
+
 std::vector<Manifest *> ProtectionGraph::topologicalSortManifests(const std::set<Manifest *> &manifests) {
   std::set<Manifest *> all{manifests.begin(), manifests.end()};
   std::set<Manifest *> seen{};
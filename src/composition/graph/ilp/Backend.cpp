@@ -0,0 +1,40 @@
+#include <composition/graph/ilp/Backend.hpp>
+#include <composition/graph/ilp/GLPKBackend.hpp>
+#include <composition/graph/ilp/HiGHSBackend.hpp>
+#include <llvm/ADT/Twine.h>
+#include <llvm/Support/ErrorHandling.h>
+
+namespace composition::graph::ilp {
+
+std::unique_ptr<Backend> createBackend(const std::string &name) {
+  if (name == "glpk") {
+    return std::make_unique<GLPKBackend>();
+  }
+#ifdef COMPOSITION_HAVE_HIGHS
+  if (name == "highs") {
+    return std::make_unique<HiGHSBackend>();
+  }
+#endif
+  llvm::report_fatal_error(llvm::Twine("ILP backend '") + name + "' is unknown or was not compiled in");
+}
+
+const char *toString(Status status) {
+  switch (status) {
+  case Status::Optimal:return "optimal";
+  case Status::Feasible:return "feasible";
+  case Status::Infeasible:return "infeasible";
+  case Status::Unbounded:return "unbounded";
+  case Status::Undefined:return "undefined";
+  }
+  return "undefined";
+}
+
+std::string describe(const Parameters &params) {
+  static const char *branching[] = {"first-fractional", "last-fractional", "most-fractional", "driebeck-tomlin",
+                                    "pseudo-cost"};
+  static const char *backtracking[] = {"depth-first", "breadth-first", "best-local-bound", "best-projection"};
+  return std::string("branching=") + branching[static_cast<int>(params.branching)] + " backtracking=" +
+      backtracking[static_cast<int>(params.backtracking)] + " cuts=" + (params.cuts ? "on" : "off") + " presolve=" +
+      (params.presolve ? "on" : "off");
+}
+} // namespace composition::graph::ilp
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <composition/graph/ilp/Cache.hpp>
+#include <fstream>
+#include <iomanip>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/Debug.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/Path.h>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace composition::graph::ilp {
+
+Cache::Cache(std::string directory) : directory(std::move(directory)) {}
+
+std::string Cache::path(const std::string &key) const {
+  llvm::SmallString<128> result{directory};
+  llvm::sys::path::append(result, key + ".json");
+  return result.str().str();
+}
+
+std::string Cache::key(const Model &model, const std::string &configuration) {
+  // Rows and columns are referred to by name and sorted, such that the insertion order does not change the key
+  std::vector<std::vector<std::string>> rowCoefficients(model.rows.size());
+  for (size_t i = 0; i < model.matrixCoeffs.size(); ++i) {
+    std::ostringstream os;
+    os << std::setprecision(17) << model.columnName(model.matrixCols[i]) << ":" << model.matrixCoeffs[i];
+    rowCoefficients[model.matrixRows[i] - 1].push_back(os.str());
+  }
+
+  std::vector<std::string> rows{};
+  for (size_t i = 0; i < model.rows.size(); ++i) {
+    const auto &row = model.rows[i];
+    auto &coefficients = rowCoefficients[i];
+    std::sort(coefficients.begin(), coefficients.end());
+
+    std::ostringstream os;
+    os << std::setprecision(17) << row.name << "|" << static_cast<int>(row.type) << "|" << row.lb << "|" << row.ub;
+    for (auto &c : coefficients) {
+      os << "|" << c;
+    }
+    rows.push_back(os.str());
+  }
+  std::sort(rows.begin(), rows.end());
+
+  std::vector<std::string> columns{};
+  for (const auto &col : model.columns) {
+    std::ostringstream os;
+    os << std::setprecision(17) << col.name << "|" << static_cast<int>(col.kind) << "|" << static_cast<int>(col.type)
+       << "|" << col.lb << "|" << col.ub << "|" << col.objective;
+    columns.push_back(os.str());
+  }
+  std::sort(columns.begin(), columns.end());
+
+  llvm::MD5 hash{};
+  hash.update(configuration);
+  hash.update(std::to_string(static_cast<int>(model.direction)));
+  for (auto &r : rows) {
+    hash.update(r);
+    hash.update("\n");
+  }
+  for (auto &c : columns) {
+    hash.update(c);
+    hash.update("\n");
+  }
+
+  llvm::MD5::MD5Result result{};
+  hash.final(result);
+  llvm::SmallString<32> digest{};
+  llvm::MD5::stringifyResult(result, digest);
+  return digest.str().str();
+}
+
+std::optional<std::set<std::string>> Cache::lookup(const std::string &key) const {
+  std::ifstream ifs(path(key));
+  if (!ifs.good()) {
+    return std::nullopt;
+  }
+
+  nlohmann::json j = nlohmann::json::parse(ifs, nullptr, false);
+  if (j.is_discarded() || !j.contains("columns")) {
+    llvm::dbgs() << "ILP cache entry " << key << " is corrupt, ignoring it\n";
+    return std::nullopt;
+  }
+  return j.at("columns").get<std::set<std::string>>();
+}
+
+void Cache::store(const std::string &key, const std::set<std::string> &columns) const {
+  if (auto ec = llvm::sys::fs::create_directories(directory)) {
+    llvm::dbgs() << "Could not create ILP cache directory " << directory << ": " << ec.message() << "\n";
+    return;
+  }
+
+  // Write to a temporary file first, concurrent compilations must never read a partial entry
+  std::string target = path(key);
+  llvm::SmallString<128> temporary{};
+  if (auto ec = llvm::sys::fs::createUniqueFile(target + "-%%%%%%.tmp", temporary)) {
+    llvm::dbgs() << "Could not write ILP cache entry " << target << ": " << ec.message() << "\n";
+    return;
+  }
+  {
+    std::ofstream ofs(temporary.str().str());
+    nlohmann::json j{{"columns", columns}};
+    ofs << j.dump(4) << "\n";
+  }
+  if (auto ec = llvm::sys::fs::rename(temporary, target)) {
+    llvm::dbgs() << "Could not write ILP cache entry " << target << ": " << ec.message() << "\n";
+    llvm::sys::fs::remove(temporary);
+  }
+}
+
+} // namespace composition::graph::ilp
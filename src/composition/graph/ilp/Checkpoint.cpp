@@ -0,0 +1,82 @@
+#include <composition/graph/ilp/Checkpoint.hpp>
+#include <fstream>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/Debug.h>
+#include <llvm/Support/FileSystem.h>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <utility>
+
+namespace composition::graph::ilp {
+
+Checkpoint::Checkpoint(std::string file, std::string key, Direction direction)
+    : file(std::move(file)), key(std::move(key)), direction(direction) {}
+
+std::optional<Checkpoint::Entry> Checkpoint::load(const Model &model) {
+  std::ifstream ifs(file);
+  if (!ifs.good()) {
+    return std::nullopt;
+  }
+
+  nlohmann::json j = nlohmann::json::parse(ifs, nullptr, false);
+  if (j.is_discarded() || !j.contains("key") || !j.contains("objective") || !j.contains("columns")) {
+    llvm::dbgs() << "ILP checkpoint " << file << " is corrupt, ignoring it\n";
+    return std::nullopt;
+  }
+  if (j.at("key").get<std::string>() != key) {
+    llvm::dbgs() << "ILP checkpoint " << file << " belongs to another model, ignoring it\n";
+    return std::nullopt;
+  }
+
+  // Columns are saved by name, only the non-zero ones
+  std::map<std::string, int> columns{};
+  for (int col = 1; col <= model.numColumns(); ++col) {
+    columns.insert({model.columnName(col), col});
+  }
+  Entry entry{j.at("objective").get<double>(), std::vector<double>(static_cast<size_t>(model.numColumns()), 0.0)};
+  for (auto &[name, value] : j.at("columns").items()) {
+    auto found = columns.find(name);
+    if (found == columns.end()) {
+      llvm::dbgs() << "ILP checkpoint " << file << " has the unknown column " << name << ", ignoring it\n";
+      return std::nullopt;
+    }
+    entry.values[found->second - 1] = value.get<double>();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  best = entry.objective;
+  return entry;
+}
+
+void Checkpoint::store(const Model &model, const std::vector<double> &values, double objective,
+                       const std::vector<uint64_t> &manifests) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (best && (direction == Direction::Minimize ? objective >= *best : objective <= *best)) {
+    return;
+  }
+  best = objective;
+
+  nlohmann::json columns = nlohmann::json::object();
+  for (int col = 1; col <= model.numColumns(); ++col) {
+    if (values[col - 1] != 0.0) {
+      columns[model.columnName(col)] = values[col - 1];
+    }
+  }
+  nlohmann::json j{{"key", key}, {"objective", objective}, {"manifests", manifests}, {"columns", columns}};
+
+  // A job killed while writing must not leave a partial checkpoint behind
+  llvm::SmallString<128> temporary{};
+  if (auto ec = llvm::sys::fs::createUniqueFile(file + "-%%%%%%.tmp", temporary)) {
+    llvm::dbgs() << "Could not write ILP checkpoint " << file << ": " << ec.message() << "\n";
+    return;
+  }
+  {
+    std::ofstream ofs(temporary.str().str());
+    ofs << j.dump(4) << "\n";
+  }
+  if (auto ec = llvm::sys::fs::rename(temporary, file)) {
+    llvm::dbgs() << "Could not write ILP checkpoint " << file << ": " << ec.message() << "\n";
+    llvm::sys::fs::remove(temporary);
+  }
+}
+} // namespace composition::graph::ilp
@@ -0,0 +1,303 @@
+#include <composition/graph/ilp/GLPKBackend.hpp>
+#include <llvm/Support/Debug.h>
+#include <llvm/Support/raw_ostream.h>
+#include <string>
+
+namespace composition::graph::ilp {
+
+int boundType(BoundType type) {
+  switch (type) {
+  case BoundType::Free:return GLP_FR;
+  case BoundType::Lower:return GLP_LO;
+  case BoundType::Upper:return GLP_UP;
+  case BoundType::Double:return GLP_DB;
+  case BoundType::Fixed:return GLP_FX;
+  }
+  return GLP_FR;
+}
+
+int columnKind(ColumnKind kind) {
+  switch (kind) {
+  case ColumnKind::Continuous:return GLP_CV;
+  case ColumnKind::Integer:return GLP_IV;
+  case ColumnKind::Binary:return GLP_BV;
+  }
+  return GLP_CV;
+}
+
+int branchingTechnique(Branching branching) {
+  switch (branching) {
+  case Branching::FirstFractional:return GLP_BR_FFV;
+  case Branching::LastFractional:return GLP_BR_LFV;
+  case Branching::MostFractional:return GLP_BR_MFV;
+  case Branching::DriebeckTomlin:return GLP_BR_DTH;
+  case Branching::PseudoCost:return GLP_BR_PCH;
+  }
+  return GLP_BR_PCH;
+}
+
+int backtrackingTechnique(Backtracking backtracking) {
+  switch (backtracking) {
+  case Backtracking::DepthFirst:return GLP_BT_DFS;
+  case Backtracking::BreadthFirst:return GLP_BT_BFS;
+  case Backtracking::BestLocalBound:return GLP_BT_BLB;
+  case Backtracking::BestProjection:return GLP_BT_BPH;
+  }
+  return GLP_BT_BLB;
+}
+
+/**
+ * State of the branch-and-bound callback
+ */
+struct CallbackInfo {
+  const Parameters *params;
+  glp_prob *lp;
+  bool warmStarted = false;
+};
+
+void branchAndBoundCallback(glp_tree *tree, void *info) {
+  auto *state = static_cast<CallbackInfo *>(info);
+  const Parameters &params = *state->params;
+  if (params.cancel != nullptr && params.cancel->load()) {
+    glp_ios_terminate(tree);
+    return;
+  }
+
+  switch (glp_ios_reason(tree)) {
+  case GLP_IHEUR:
+    // The first heuristic request offers the warm start as the initial incumbent, GLPK rejects it if infeasible
+    if (params.warmStart != nullptr && !state->warmStarted) {
+      state->warmStarted = true;
+      std::vector<double> x(1, 0.0);
+      x.insert(x.end(), params.warmStart->begin(), params.warmStart->end());
+      if (glp_ios_heur_sol(tree, x.data()) == 0 && !params.quiet) {
+        llvm::dbgs() << "MIP warm start accepted\n";
+      }
+    }
+    break;
+  case GLP_IBINGO:
+    if (params.onIncumbent) {
+      int columns = glp_get_num_cols(state->lp);
+      std::vector<double> values(static_cast<size_t>(columns));
+      for (int j = 1; j <= columns; ++j) {
+        values[j - 1] = glp_mip_col_val(state->lp, j);
+      }
+      params.onIncumbent(values, glp_mip_obj_val(state->lp));
+    }
+    break;
+  default:break;
+  }
+}
+
+GLPKBackend::GLPKBackend() {
+  lp = glp_create_prob();          // creates a problem object
+  glp_set_prob_name(lp, "sample"); // assigns a symbolic name to the problem object
+}
+
+GLPKBackend::~GLPKBackend() {
+  if (lp != nullptr) {
+    glp_delete_prob(lp);
+  }
+  lp = nullptr;
+}
+
+void GLPKBackend::load(const Model &model) {
+  glp_erase_prob(lp);
+  glp_set_prob_name(lp, "sample");
+  glp_set_obj_dir(lp, model.direction == Direction::Minimize ? GLP_MIN : GLP_MAX);
+
+  if (model.numRows() > 0) {
+    glp_add_rows(lp, model.numRows());
+  }
+  for (int i = 1; i <= model.numRows(); ++i) {
+    const Row &r = model.rows[i - 1];
+    glp_set_row_name(lp, i, r.name.c_str());
+    glp_set_row_bnds(lp, i, boundType(r.type), r.lb, r.ub);
+  }
+
+  if (model.numColumns() > 0) {
+    glp_add_cols(lp, model.numColumns());
+  }
+  for (int j = 1; j <= model.numColumns(); ++j) {
+    const Column &c = model.columns[j - 1];
+    glp_set_col_name(lp, j, c.name.c_str());
+    glp_set_col_kind(lp, j, columnKind(c.kind));
+    if (c.kind != ColumnKind::Binary) {
+      glp_set_col_bnds(lp, j, boundType(c.type), c.lb, c.ub);
+    }
+    glp_set_obj_coef(lp, j, c.objective);
+  }
+
+  // now prepend the required position zero placeholder (any value will do but zero is safe)
+  // first create length one vectors using default member construction
+  std::vector<int> iav(1, 0);
+  std::vector<int> jav(1, 0);
+  std::vector<double> arv(1, 0);
+
+  // then concatenate these with the original data vectors
+  iav.insert(iav.end(), model.matrixRows.begin(), model.matrixRows.end());
+  jav.insert(jav.end(), model.matrixCols.begin(), model.matrixCols.end());
+  arv.insert(arv.end(), model.matrixCoeffs.begin(), model.matrixCoeffs.end());
+
+  glp_load_matrix(lp, static_cast<int>(model.numCoefficients()), &iav[0], &jav[0], &arv[0]);
+}
+
+void GLPKBackend::report(const std::string &message) {
+  outcome = message;
+  if (!quiet) {
+    llvm::dbgs() << message << "\n";
+  }
+}
+
+Status GLPKBackend::solveRelaxation(const Parameters &params) {
+  if (params.lpMethod == LPMethod::Interior) {
+    solution = Solution::Interior;
+    glp_iptcp iptcp{};
+    glp_init_iptcp(&iptcp);
+    if (quiet) {
+      iptcp.msg_lev = GLP_MSG_OFF;
+    }
+    int ecode = glp_interior(lp, &iptcp);
+    int status = glp_ipt_status(lp);
+    report("Interior point exit code: " + std::to_string(ecode) + " status code: " + std::to_string(status));
+
+    switch (status) {
+    case GLP_OPT:return Status::Optimal;
+    case GLP_NOFEAS:return Status::Infeasible;
+    default:break;
+    }
+    return Status::Undefined;
+  }
+
+  solution = Solution::Simplex;
+  glp_smcp smcp{};
+  glp_init_smcp(&smcp);
+  smcp.presolve = params.presolve ? GLP_ON : GLP_OFF;
+  if (params.timeLimit > 0) {
+    smcp.tm_lim = static_cast<int>(params.timeLimit * 1000);
+  }
+  if (quiet) {
+    smcp.msg_lev = GLP_MSG_OFF;
+  }
+  int ecode = glp_simplex(lp, &smcp);
+  int status = glp_get_status(lp);
+  report("Simplex exit code: " + std::to_string(ecode) + " status code: " + std::to_string(status));
+
+  switch (status) {
+  case GLP_OPT:return Status::Optimal;
+  case GLP_FEAS:return Status::Feasible;
+  case GLP_INFEAS:
+  case GLP_NOFEAS:return Status::Infeasible;
+  case GLP_UNBND:return Status::Unbounded;
+  default:break;
+  }
+  return Status::Undefined;
+}
+
+Status GLPKBackend::solve(const Parameters &params) {
+  quiet = params.quiet;
+  if (params.relaxation) {
+    return solveRelaxation(params);
+  }
+  solution = Solution::MIP;
+
+  glp_iocp iocp{};
+  glp_init_iocp(&iocp);
+
+  iocp.gmi_cuts = params.cuts ? GLP_ON : GLP_OFF;
+  iocp.br_tech = branchingTechnique(params.branching);
+  iocp.bt_tech = backtrackingTechnique(params.backtracking);
+  // The callback sees the columns of the presolved problem, incumbents and warm starts need the original ones
+  bool presolve = params.presolve && !params.onIncumbent && params.warmStart == nullptr;
+  iocp.presolve = presolve ? GLP_ON : GLP_OFF;
+  if (params.timeLimit > 0) {
+    iocp.tm_lim = static_cast<int>(params.timeLimit * 1000);
+  }
+  if (quiet) {
+    iocp.msg_lev = GLP_MSG_OFF;
+  }
+  CallbackInfo info{&params, lp};
+  if (params.cancel != nullptr || params.onIncumbent || params.warmStart != nullptr) {
+    iocp.cb_func = branchAndBoundCallback;
+    iocp.cb_info = &info;
+  }
+
+  if (!presolve) {
+    // Without the MIP presolver glp_intopt requires an optimal basis of the LP relaxation
+    glp_smcp smcp{};
+    glp_init_smcp(&smcp);
+    if (quiet) {
+      smcp.msg_lev = GLP_MSG_OFF;
+    }
+    int lp_ecode = glp_simplex(lp, &smcp);
+    if (lp_ecode != 0 || glp_get_status(lp) != GLP_OPT) {
+      report("LP relaxation exit code: " + std::to_string(lp_ecode) + " status code: " +
+          std::to_string(glp_get_status(lp)));
+      return glp_get_status(lp) == GLP_UNBND ? Status::Unbounded : Status::Infeasible;
+    }
+  }
+
+  int mip_ecode = glp_intopt(lp, &iocp);
+  int mip_status = glp_mip_status(lp);
+  report("MIP exit code: " + std::to_string(mip_ecode) + " status code: " + std::to_string(mip_status));
+  // The MIP presolver stops without a status if it proves the problem infeasible
+  if (mip_ecode == GLP_ENOPFS) {
+    return Status::Infeasible;
+  }
+
+  switch (mip_status) {
+  case GLP_OPT:return Status::Optimal;
+  case GLP_FEAS:return Status::Feasible;
+  case GLP_NOFEAS:return Status::Infeasible;
+  default:break;
+  }
+  return Status::Undefined;
+}
+
+void GLPKBackend::setRowBounds(int row, BoundType type, double lb, double ub) {
+  glp_set_row_bnds(lp, row, boundType(type), lb, ub);
+}
+
+double GLPKBackend::objectiveValue() const {
+  switch (solution) {
+  case Solution::Simplex:return glp_get_obj_val(lp);
+  case Solution::Interior:return glp_ipt_obj_val(lp);
+  case Solution::MIP:break;
+  }
+  return glp_mip_obj_val(lp);
+}
+
+double GLPKBackend::columnValue(int col) const {
+  switch (solution) {
+  case Solution::Simplex:return glp_get_col_prim(lp, col);
+  case Solution::Interior:return glp_ipt_col_prim(lp, col);
+  case Solution::MIP:break;
+  }
+  return glp_mip_col_val(lp, col);
+}
+
+double GLPKBackend::rowValue(int row) const {
+  switch (solution) {
+  case Solution::Simplex:return glp_get_row_prim(lp, row);
+  case Solution::Interior:return glp_ipt_row_prim(lp, row);
+  case Solution::MIP:break;
+  }
+  return glp_mip_row_val(lp, row);
+}
+
+void GLPKBackend::writeProblem(const std::string &file) { glp_write_lp(lp, nullptr, file.c_str()); }
+
+void GLPKBackend::writeSolution(const std::string &file) {
+  // GLPK announces every file it writes on the terminal
+  int terminal = glp_term_out(quiet ? GLP_OFF : GLP_ON);
+  glp_write_mip(lp, file.c_str());
+  glp_term_out(terminal);
+}
+
+void GLPKBackend::writeReadableSolution(const std::string &file) { glp_print_mip(lp, file.c_str()); }
+
+bool GLPKBackend::readSolution(const std::string &file) {
+  solution = Solution::MIP;
+  return glp_read_mip(lp, file.c_str()) == 0;
+}
+} // namespace composition::graph::ilp
@@ -0,0 +1,121 @@
+#include <composition/graph/ilp/HiGHSBackend.hpp>
+
+#ifdef COMPOSITION_HAVE_HIGHS
+#include <llvm/Support/Debug.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace composition::graph::ilp {
+
+std::pair<double, double> bounds(BoundType type, double lb, double ub) {
+  switch (type) {
+  case BoundType::Free:return {-kHighsInf, kHighsInf};
+  case BoundType::Lower:return {lb, kHighsInf};
+  case BoundType::Upper:return {-kHighsInf, ub};
+  case BoundType::Double:return {lb, ub};
+  case BoundType::Fixed:return {lb, lb};
+  }
+  return {-kHighsInf, kHighsInf};
+}
+
+HiGHSBackend::HiGHSBackend() { highs.setOptionValue("output_flag", false); }
+
+void HiGHSBackend::load(const Model &model) {
+  HighsLp lp{};
+  lp.num_col_ = model.numColumns();
+  lp.num_row_ = model.numRows();
+  lp.sense_ = model.direction == Direction::Minimize ? ObjSense::kMinimize : ObjSense::kMaximize;
+
+  for (const Column &c : model.columns) {
+    auto[lb, ub] = c.kind == ColumnKind::Binary ? std::make_pair(0.0, 1.0) : bounds(c.type, c.lb, c.ub);
+    lp.col_cost_.push_back(c.objective);
+    lp.col_lower_.push_back(lb);
+    lp.col_upper_.push_back(ub);
+    lp.col_names_.push_back(c.name);
+    lp.integrality_.push_back(c.kind == ColumnKind::Continuous ? HighsVarType::kContinuous : HighsVarType::kInteger);
+  }
+
+  for (const Row &r : model.rows) {
+    auto[lb, ub] = bounds(r.type, r.lb, r.ub);
+    lp.row_lower_.push_back(lb);
+    lp.row_upper_.push_back(ub);
+    lp.row_names_.push_back(r.name);
+  }
+
+  // HiGHS expects a column-wise, zero-based matrix
+  auto &a = lp.a_matrix_;
+  a.format_ = MatrixFormat::kColwise;
+  a.num_col_ = lp.num_col_;
+  a.num_row_ = lp.num_row_;
+  a.start_.assign(lp.num_col_ + 1, 0);
+  for (int col : model.matrixCols) {
+    ++a.start_[col];
+  }
+  for (int j = 0; j < lp.num_col_; ++j) {
+    a.start_[j + 1] += a.start_[j];
+  }
+  a.index_.resize(model.numCoefficients());
+  a.value_.resize(model.numCoefficients());
+  std::vector<HighsInt> next{a.start_.begin(), a.start_.end() - 1};
+  for (size_t k = 0; k < model.numCoefficients(); ++k) {
+    auto pos = next[model.matrixCols[k] - 1]++;
+    a.index_[pos] = model.matrixRows[k] - 1;
+    a.value_[pos] = model.matrixCoeffs[k];
+  }
+
+  highs.passModel(std::move(lp));
+}
+
+Status HiGHSBackend::solve(const Parameters &params) {
+  highs.setOptionValue("presolve", params.presolve ? "on" : "off");
+  highs.setOptionValue("time_limit", params.timeLimit > 0 ? params.timeLimit : kHighsInf);
+  highs.setOptionValue("solve_relaxation", params.relaxation);
+  highs.setOptionValue("solver", params.relaxation && params.lpMethod == LPMethod::Interior ? "ipm" : "choose");
+  if (params.warmStart != nullptr && !params.relaxation) {
+    HighsSolution start{};
+    start.col_value = *params.warmStart;
+    highs.setSolution(start);
+  }
+
+  highs.run();
+  auto modelStatus = highs.getModelStatus();
+  outcome = "HiGHS model status: " + highs.modelStatusToString(modelStatus);
+  if (!params.quiet) {
+    llvm::dbgs() << outcome << "\n";
+  }
+
+  switch (modelStatus) {
+  case HighsModelStatus::kOptimal:return Status::Optimal;
+  case HighsModelStatus::kInfeasible:return Status::Infeasible;
+  case HighsModelStatus::kUnbounded:
+  case HighsModelStatus::kUnboundedOrInfeasible:return Status::Unbounded;
+  default:break;
+  }
+  if (highs.getInfo().primal_solution_status == kSolutionStatusFeasible) {
+    return Status::Feasible;
+  }
+  return Status::Undefined;
+}
+
+void HiGHSBackend::setRowBounds(int row, BoundType type, double lb, double ub) {
+  auto[lower, upper] = bounds(type, lb, ub);
+  highs.changeRowBounds(row - 1, lower, upper);
+}
+
+double HiGHSBackend::objectiveValue() const { return highs.getInfo().objective_function_value; }
+
+double HiGHSBackend::columnValue(int col) const { return highs.getSolution().col_value.at(col - 1); }
+
+double HiGHSBackend::rowValue(int row) const { return highs.getSolution().row_value.at(row - 1); }
+
+void HiGHSBackend::writeProblem(const std::string &file) { highs.writeModel(file); }
+
+void HiGHSBackend::writeSolution(const std::string &file) { highs.writeSolution(file, kSolutionStyleRaw); }
+
+void HiGHSBackend::writeReadableSolution(const std::string &file) { highs.writeSolution(file, kSolutionStylePretty); }
+
+bool HiGHSBackend::readSolution(const std::string &file) {
+  return highs.readSolution(file, kSolutionStyleRaw) == HighsStatus::kOk;
+}
+} // namespace composition::graph::ilp
+
+#endif // COMPOSITION_HAVE_HIGHS
@@ -0,0 +1,46 @@
+#include <composition/graph/ilp/Model.hpp>
+
+namespace composition::graph::ilp {
+
+int Model::addRow() {
+  rows.emplace_back();
+  return numRows();
+}
+
+int Model::addColumn() {
+  columns.emplace_back();
+  return numColumns();
+}
+
+void Model::setRowName(int row, const std::string &name) { rows.at(row - 1).name = name; }
+
+void Model::setRowBounds(int row, BoundType type, double lb, double ub) {
+  auto &r = rows.at(row - 1);
+  r.type = type;
+  r.lb = lb;
+  r.ub = ub;
+}
+
+void Model::setColumnName(int col, const std::string &name) { columns.at(col - 1).name = name; }
+
+void Model::setColumnKind(int col, ColumnKind kind) { columns.at(col - 1).kind = kind; }
+
+void Model::setColumnBounds(int col, BoundType type, double lb, double ub) {
+  auto &c = columns.at(col - 1);
+  c.type = type;
+  c.lb = lb;
+  c.ub = ub;
+}
+
+void Model::setObjective(int col, double coefficient) { columns.at(col - 1).objective = coefficient; }
+
+const std::string &Model::rowName(int row) const { return rows.at(row - 1).name; }
+
+const std::string &Model::columnName(int col) const { return columns.at(col - 1).name; }
+
+void Model::addCoefficient(int row, int col, double value) {
+  matrixRows.push_back(row);
+  matrixCols.push_back(col);
+  matrixCoeffs.push_back(value);
+}
+} // namespace composition::graph::ilp
@@ -0,0 +1,28 @@
+#include <composition/graph/ilp/Objective.hpp>
+#include <llvm/ADT/Twine.h>
+#include <llvm/Support/ErrorHandling.h>
+
+namespace composition::graph::ilp {
+
+std::unique_ptr<Objective> createObjective(const std::string &name) {
+  if (name == MaxExplicit::Name) {
+    return std::make_unique<ObjectiveModule<MaxExplicit>>();
+  }
+  if (name == MaxImplicit::Name) {
+    return std::make_unique<ObjectiveModule<MaxImplicit>>();
+  }
+  if (name == MaxConnectivity::Name) {
+    return std::make_unique<ObjectiveModule<MaxConnectivity>>();
+  }
+  if (name == MaxManifest::Name) {
+    return std::make_unique<ObjectiveModule<MaxManifest>>();
+  }
+  if (name == MinSize::Name) {
+    return std::make_unique<ObjectiveModule<MinSize>>();
+  }
+  if (name == MinOverhead::Name) {
+    return std::make_unique<ObjectiveModule<MinOverhead>>();
+  }
+  llvm::report_fatal_error(llvm::Twine("Unknown ILP objective '") + name + "'");
+}
+} // namespace composition::graph::ilp
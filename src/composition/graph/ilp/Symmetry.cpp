@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <cmath>
+#include <composition/graph/ilp/Symmetry.hpp>
+#include <map>
+#include <set>
+#include <tuple>
+#include <utility>
+
+namespace composition::graph::ilp {
+namespace {
+/**
+ * A row repeated for each member of a class is the same up to the member, the key is everything else
+ */
+using row_key_t = std::tuple<BoundType, double, double, double, std::vector<std::pair<int, double>>>;
+
+/**
+ * Column added for a collapsed class, named after its first member
+ */
+Column derived(const Column &member, const std::string &prefix, ColumnKind kind, double ub, double objective) {
+  Column c{};
+  c.name = prefix + member.name;
+  c.kind = kind;
+  c.type = BoundType::Double;
+  c.lb = 0.0;
+  c.ub = ub;
+  c.objective = objective;
+  return c;
+}
+} // namespace
+
+double Collapsed::value(int col, const std::function<double(int)> &value) const {
+  auto[c, position] = origin[col - 1];
+  double v = value(c);
+  if (members[c - 1].size() == 1) {
+    return v;
+  }
+  return static_cast<long>(position) < std::lround(v) ? 1.0 : 0.0;
+}
+
+Collapsed collapseSymmetries(const Model &model, const std::vector<std::vector<int>> &classes) {
+  // Row wise coefficients, the columns of collapsed classes are numbered after the original ones
+  std::vector<Row> rows = model.rows;
+  std::vector<std::map<int, double>> rowEntries(model.rows.size());
+  std::vector<std::vector<int>> columnRows(model.columns.size());
+  for (size_t k = 0; k < model.numCoefficients(); ++k) {
+    rowEntries[model.matrixRows[k] - 1][model.matrixCols[k]] += model.matrixCoeffs[k];
+    columnRows[model.matrixCols[k] - 1].push_back(model.matrixRows[k]);
+  }
+  std::vector<Column> columns = model.columns;
+  std::vector<std::vector<int>> columnMembers{};
+  for (int col = 1; col <= model.numColumns(); ++col) {
+    columnMembers.push_back({col});
+  }
+  std::vector<bool> removed(model.columns.size(), false);
+
+  Collapsed result{};
+  for (auto &cls : classes) {
+    if (cls.size() < 2) {
+      continue;
+    }
+    const Column &first = model.columns[cls.front() - 1];
+    bool valid = std::all_of(cls.begin(), cls.end(), [&](int col) {
+      const Column &c = model.columns[col - 1];
+      return !removed[col - 1] && c.kind == ColumnKind::Binary && c.objective == first.objective &&
+          c.lb == first.lb && c.ub == first.ub;
+    });
+    if (!valid) {
+      continue;
+    }
+
+    std::set<int> memberSet(cls.begin(), cls.end());
+    std::set<int> touched{};
+    for (int col : cls) {
+      touched.insert(columnRows[col - 1].begin(), columnRows[col - 1].end());
+    }
+    std::vector<std::pair<int, double>> shared{};
+    std::map<row_key_t, std::map<int, std::vector<int>>> families{};
+    for (int row : touched) {
+      auto &entries = rowEntries[row - 1];
+      std::vector<std::pair<int, double>> inRow{};
+      std::vector<std::pair<int, double>> others{};
+      for (auto &[col, coefficient] : entries) {
+        (memberSet.count(col) > 0 ? inRow : others).emplace_back(col, coefficient);
+      }
+      bool equal = std::all_of(inRow.begin(), inRow.end(), [&](auto &e) { return e.second == inRow.front().second; });
+      if (inRow.empty()) {
+        continue;
+      } else if (inRow.size() == cls.size() && equal) {
+        shared.emplace_back(row, inRow.front().second);
+      } else if (inRow.size() == 1) {
+        const Row &r = rows[row - 1];
+        families[{r.type, r.lb, r.ub, inRow.front().second, others}][inRow.front().first].push_back(row);
+      } else {
+        valid = false;
+        break;
+      }
+    }
+    // Every member needs its copy of every repeated row
+    for (auto &[key, byMember] : families) {
+      valid = valid && byMember.size() == cls.size() &&
+          std::all_of(byMember.begin(), byMember.end(), [&](auto &m) {
+            return m.second.size() == byMember.begin()->second.size();
+          });
+    }
+    if (!valid) {
+      continue;
+    }
+
+    auto size = static_cast<double>(cls.size());
+    int count = static_cast<int>(columns.size()) + 1;
+    columns.push_back(derived(first, "count_", ColumnKind::Integer, size, first.objective));
+    columnMembers.push_back(cls);
+    int any = count + 1;
+    columns.push_back(derived(first, "any_", ColumnKind::Binary, 1.0, 0.0));
+    columnMembers.push_back({});
+    int all = count + 2;
+    columns.push_back(derived(first, "all_", ColumnKind::Binary, 1.0, 0.0));
+    columnMembers.push_back({});
+    for (int col : cls) {
+      removed[col - 1] = true;
+    }
+    removed.resize(columns.size(), false);
+
+    // sum of a * mj = a * count
+    for (auto &[row, coefficient] : shared) {
+      for (int col : cls) {
+        rowEntries[row - 1].erase(col);
+      }
+      rowEntries[row - 1][count] = coefficient;
+    }
+    // A repeated row holds for the selected members iff it holds with any = 1, for the others iff with all = 0
+    for (auto &[key, byMember] : families) {
+      double coefficient = std::get<3>(key);
+      std::vector<int> copies{};
+      for (auto &[member, memberRows] : byMember) {
+        for (int row : memberRows) {
+          rowEntries[row - 1].erase(member);
+          copies.push_back(row);
+        }
+      }
+      rowEntries[copies[0] - 1][any] = coefficient;
+      rowEntries[copies[1] - 1][all] = coefficient;
+      for (size_t i = 2; i < copies.size(); ++i) {
+        rowEntries[copies[i] - 1].clear();
+        rows[copies[i] - 1].type = BoundType::Free;
+        rows[copies[i] - 1].lb = 0.0;
+        rows[copies[i] - 1].ub = 0.0;
+      }
+    }
+    // any <= count <= size * any; size * all <= count <= size - 1 + all
+    auto link = [&](const std::string &name, BoundType type, double lb, double ub, int flag, double coefficient) {
+      Row r{};
+      r.name = name + first.name;
+      r.type = type;
+      r.lb = lb;
+      r.ub = ub;
+      rows.push_back(r);
+      rowEntries.push_back({{count, 1.0}, {flag, coefficient}});
+    };
+    link("any_lb_", BoundType::Lower, 0.0, 0.0, any, -1.0);
+    link("any_ub_", BoundType::Upper, 0.0, 0.0, any, -size);
+    link("all_lb_", BoundType::Lower, 0.0, 0.0, all, -size);
+    link("all_ub_", BoundType::Upper, 0.0, size - 1, all, -1.0);
+    ++result.classes;
+  }
+
+  // Renumber the remaining columns
+  std::vector<int> index(columns.size(), 0);
+  result.model.direction = model.direction;
+  result.model.rows = rows;
+  for (size_t c = 0; c < columns.size(); ++c) {
+    if (!removed[c]) {
+      result.model.columns.push_back(columns[c]);
+      result.members.push_back(columnMembers[c]);
+      index[c] = result.model.numColumns();
+    }
+  }
+  result.origin.resize(model.columns.size());
+  for (size_t c = 0; c < result.members.size(); ++c) {
+    auto &ms = result.members[c];
+    for (size_t position = 0; position < ms.size(); ++position) {
+      result.origin[ms[position] - 1] = {static_cast<int>(c + 1), position};
+    }
+  }
+  for (size_t r = 0; r < rowEntries.size(); ++r) {
+    for (auto &[col, coefficient] : rowEntries[r]) {
+      result.model.addCoefficient(static_cast<int>(r + 1), index[col - 1], coefficient);
+    }
+  }
+  return result;
+}
+} // namespace composition::graph::ilp
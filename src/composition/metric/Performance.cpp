@@ -1,16 +1,44 @@
 #include <composition/metric/Performance.hpp>
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <string>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/CallSite.h>
+#include <llvm/IR/DebugInfoMetadata.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/Support/Path.h>
+#include <nlohmann/json.hpp>
+#include <unordered_set>
+#include <vector>
 
 // @src: https://github.com/rcorcs/llvm-heat-printer
 
 namespace composition::metric {
 using llvm::BasicBlock;
 using llvm::BlockFrequencyInfo;
+using llvm::CallSite;
 using llvm::Function;
 using llvm::function_ref;
 using llvm::LLVMContext;
 using llvm::Module;
 
+namespace {
+/**
+ * Heuristic frequency of `BB` relative to the entry of its function
+ */
+double relativeFreq(const BasicBlock &BB, BlockFrequencyInfo *BFI) {
+  return static_cast<double>(BFI->getBlockFreq(&BB).getFrequency()) / std::max<uint64_t>(BFI->getEntryFreq(), 1);
+}
+
+uint64_t saturate(double freq) {
+  return freq >= static_cast<double>(std::numeric_limits<uint64_t>::max()) ? std::numeric_limits<uint64_t>::max()
+                                                                           : static_cast<uint64_t>(freq);
+}
+} // namespace
+
 bool Performance::hasProfiling(Module &M) {
   for (auto &F : M) {
     for (auto &BB : F) {
@@ -66,4 +94,234 @@ uint64_t Performance::getMaxFreq(Module &M,
   }
   return maxFreq;
 }
-} // namespace composition::metric
\ No newline at end of file
+
+std::unordered_map<BasicBlock *, uint64_t>
+Performance::estimateBlockFreqs(Module &M, function_ref<BlockFrequencyInfo *(Function &)> LookupBFI) {
+  struct CallEdge {
+    Function *callee;
+    double frequency;
+  };
+  llvm::DenseMap<Function *, BlockFrequencyInfo *> infos{};
+  llvm::DenseMap<Function *, std::vector<CallEdge>> calls{};
+  llvm::DenseMap<Function *, unsigned> callers{};
+
+  for (auto &F : M) {
+    if (!F.isDeclaration()) {
+      infos[&F] = LookupBFI(F);
+    }
+  }
+  for (auto &F : M) {
+    if (F.isDeclaration()) {
+      continue;
+    }
+    for (auto &BB : F) {
+      for (auto &I : BB) {
+        CallSite CS(&I);
+        if (!CS) {
+          continue;
+        }
+        auto *callee = CS.getCalledFunction();
+        if (callee == nullptr || callee->isDeclaration()) {
+          continue;
+        }
+        calls[&F].push_back({callee, relativeFreq(BB, infos[&F])});
+        if (callee != &F) {
+          ++callers[callee];
+        }
+      }
+    }
+  }
+
+  // Functions are visited in reverse post order of the call graph so every caller is done before its callees. Calls
+  // closing a cycle are ignored, recursion would otherwise scale the estimates without bound.
+  std::vector<Function *> postOrder{};
+  std::unordered_set<Function *> visited{};
+  auto visit = [&](Function *root) {
+    if (!visited.insert(root).second) {
+      return;
+    }
+    llvm::SmallVector<std::pair<Function *, size_t>, 16> stack{{root, 0}};
+    while (!stack.empty()) {
+      auto &[F, next] = stack.back();
+      auto &edges = calls[F];
+      if (next < edges.size()) {
+        auto *callee = edges[next++].callee;
+        if (visited.insert(callee).second) {
+          stack.push_back({callee, 0});
+        }
+        continue;
+      }
+      postOrder.push_back(F);
+      stack.pop_back();
+    }
+  };
+
+  std::vector<Function *> roots{};
+  if (auto *main = M.getFunction("main"); main != nullptr && !main->isDeclaration()) {
+    roots.push_back(main);
+  }
+  for (auto &F : M) {
+    if (!F.isDeclaration() && callers[&F] == 0) {
+      roots.push_back(&F);
+    }
+  }
+  for (auto *F : roots) {
+    visit(F);
+  }
+  // Functions only reachable through a cycle
+  for (auto &F : M) {
+    if (!F.isDeclaration() && visited.find(&F) == visited.end()) {
+      roots.push_back(&F);
+      visit(&F);
+    }
+  }
+
+  llvm::DenseMap<Function *, size_t> order{};
+  for (size_t i = 0; i < postOrder.size(); ++i) {
+    order[postOrder[i]] = i;
+  }
+  llvm::DenseMap<Function *, double> entries{};
+  for (auto *F : roots) {
+    entries[F] = StaticEntryCount;
+  }
+  for (auto it = postOrder.rbegin(); it != postOrder.rend(); ++it) {
+    auto *F = *it;
+    for (auto &edge : calls[F]) {
+      if (order[edge.callee] < order[F]) {
+        entries[edge.callee] += entries[F] * edge.frequency;
+      }
+    }
+  }
+
+  std::unordered_map<BasicBlock *, uint64_t> freqs{};
+  for (auto &F : M) {
+    if (F.isDeclaration()) {
+      continue;
+    }
+    for (auto &BB : F) {
+      freqs[&BB] = saturate(entries[&F] * relativeFreq(BB, infos[&F]));
+    }
+  }
+  return freqs;
+}
+
+std::unordered_map<BasicBlock *, uint64_t> Performance::importBlockFreqs(
+    Module &M, std::istream &profile, function_ref<BlockFrequencyInfo *(Function &)> LookupBFI) {
+  nlohmann::json j;
+  profile >> j;
+
+  std::unordered_map<std::string, uint64_t> lines{};
+  if (j.contains("lines")) {
+    lines = j["lines"].get<std::unordered_map<std::string, uint64_t>>();
+  }
+  auto lineCount = [&](const BasicBlock &BB) -> std::optional<uint64_t> {
+    std::optional<uint64_t> count{};
+    for (auto &I : BB) {
+      auto *loc = I.getDebugLoc().get();
+      if (loc == nullptr) {
+        continue;
+      }
+      auto line = ":" + std::to_string(loc->getLine());
+      auto it = lines.find(loc->getFilename().str() + line);
+      if (it == lines.end()) {
+        it = lines.find(llvm::sys::path::filename(loc->getFilename()).str() + line);
+      }
+      if (it != lines.end()) {
+        count = std::max(count.value_or(0), it->second);
+      }
+    }
+    return count;
+  };
+
+  const auto &functions = j.contains("functions") ? j["functions"] : nlohmann::json::object();
+  std::unordered_map<BasicBlock *, uint64_t> freqs{};
+  for (auto &F : M) {
+    if (F.isDeclaration()) {
+      continue;
+    }
+    auto entry = functions.find(F.getName().str());
+    std::unordered_map<std::string, uint64_t> blocks{};
+    uint64_t count = 0;
+    if (entry != functions.end()) {
+      blocks = entry->value("blocks", blocks);
+      count = entry->value("count", count);
+    }
+    auto *BFI = count > 0 ? LookupBFI(F) : nullptr;
+
+    size_t index = 0;
+    for (auto &BB : F) {
+      uint64_t freq = 0;
+      if (auto it = blocks.find(std::to_string(index)); it != blocks.end()) {
+        freq = it->second;
+      } else if (auto sampled = lineCount(BB)) {
+        freq = *sampled;
+      } else if (BFI != nullptr) {
+        freq = saturate(count * relativeFreq(BB, BFI));
+      }
+      freqs[&BB] = freq;
+      ++index;
+    }
+  }
+  return freqs;
+}
+
+double Performance::instructionCost(const llvm::Instruction *I, const std::map<std::string, float> &callCosts) {
+  // Rough latencies of a current out-of-order core, only their ratios matter
+  if (llvm::isa<llvm::DbgInfoIntrinsic>(I)) {
+    return 0.0;
+  }
+  if (auto CS = llvm::ImmutableCallSite(I)) {
+    if (auto *callee = CS.getCalledFunction()) {
+      if (auto cost = callCosts.find(callee->getName().str()); cost != callCosts.end()) {
+        return cost->second;
+      }
+      if (callee->isIntrinsic()) {
+        return 1.0;
+      }
+    }
+    return 5.0;
+  }
+  switch (I->getOpcode()) {
+  case llvm::Instruction::PHI:
+  case llvm::Instruction::BitCast:
+  case llvm::Instruction::PtrToInt:
+  case llvm::Instruction::IntToPtr:return 0.0;
+  case llvm::Instruction::Mul:return 3.0;
+  case llvm::Instruction::UDiv:
+  case llvm::Instruction::SDiv:
+  case llvm::Instruction::URem:
+  case llvm::Instruction::SRem:return 25.0;
+  case llvm::Instruction::FAdd:
+  case llvm::Instruction::FSub:
+  case llvm::Instruction::FMul:
+  case llvm::Instruction::FCmp:
+  case llvm::Instruction::FPExt:
+  case llvm::Instruction::FPTrunc:
+  case llvm::Instruction::FPToSI:
+  case llvm::Instruction::FPToUI:
+  case llvm::Instruction::SIToFP:
+  case llvm::Instruction::UIToFP:return 4.0;
+  case llvm::Instruction::FDiv:
+  case llvm::Instruction::FRem:return 20.0;
+  case llvm::Instruction::Load:return 4.0;
+  case llvm::Instruction::AtomicRMW:
+  case llvm::Instruction::AtomicCmpXchg:
+  case llvm::Instruction::Fence:return 20.0;
+  default:return 1.0;
+  }
+}
+
+double Performance::dynamicCost(const std::set<llvm::Instruction *> &instr,
+                                const std::unordered_map<BasicBlock *, uint64_t> &BFI,
+                                const std::map<std::string, float> &callCosts) {
+  double cost = 0.0;
+  for (auto *I : instr) {
+    auto found = BFI.find(I->getParent());
+    if (found == BFI.end()) {
+      continue;
+    }
+    cost += static_cast<double>(found->second) * instructionCost(I, callCosts);
+  }
+  return cost;
+}
+} // namespace composition::metric
@@ -12,6 +12,12 @@ Weights::Weights() {
   connectivityInstructions = 1.0;
   connectivityFunctions = 1.0;
   connectivityProtections = 1.0;
+
+  functionOverheadBudget = 0.0;
+  hotRegionPercentile = 90.0;
+  hotRegionOverheadBudget = 0.0;
+  functionCodeSizeBudget = 0.0;
+  callCosts = {{"oh_hash1", 4.0}, {"oh_hash2", 4.0}, {"assert", 20.0}, {"guardMe", 40.0}};
 }
 
 void Weights::dump(llvm::raw_ostream &o) {
@@ -38,7 +44,13 @@ void to_json(nlohmann::json &j, const Weights &w) {
                      {"connectivityManifest", w.connectivityManifest},
                      {"connectivityInstructions", w.connectivityInstructions},
                      {"connectivityFunctions", w.connectivityFunctions},
-                     {"connectivityProtections", w.connectivityProtections}};
+                     {"connectivityProtections", w.connectivityProtections},
+
+                     {"functionOverheadBudget", w.functionOverheadBudget},
+                     {"hotRegionPercentile", w.hotRegionPercentile},
+                     {"hotRegionOverheadBudget", w.hotRegionOverheadBudget},
+                     {"functionCodeSizeBudget", w.functionCodeSizeBudget},
+                     {"callCosts", w.callCosts}};
 }
 
 void from_json(const nlohmann::json &j, Weights &w) {
@@ -52,5 +64,17 @@ void from_json(const nlohmann::json &j, Weights &w) {
   w.connectivityInstructions = j.at("connectivityInstructions").get<float>();
   w.connectivityFunctions = j.at("connectivityFunctions").get<float>();
   w.connectivityProtections = j.at("connectivityProtections").get<float>();
+
+  // Budgets are optional, older configurations do not have them
+  w.functionOverheadBudget = j.value("functionOverheadBudget", w.functionOverheadBudget);
+  w.hotRegionPercentile = j.value("hotRegionPercentile", w.hotRegionPercentile);
+  w.hotRegionOverheadBudget = j.value("hotRegionOverheadBudget", w.hotRegionOverheadBudget);
+  w.functionCodeSizeBudget = j.value("functionCodeSizeBudget", w.functionCodeSizeBudget);
+  // Listed hooks override the defaults, the others keep theirs
+  if (auto callCosts = j.find("callCosts"); callCosts != j.end()) {
+    for (auto&[name, cost] : callCosts->get<std::map<std::string, float>>()) {
+      w.callCosts[name] = cost;
+    }
+  }
 }
 } // namespace composition::metric
\ No newline at end of file
@@ -10,14 +10,82 @@ llvm::cl::opt<std::string> WeightConfig("cf-weights", llvm::cl::Hidden,
 llvm::cl::opt<std::string> DumpStats("cf-stats", llvm::cl::Hidden,
                                      llvm::cl::desc("Dumps stats about the composition to the given file."));
 llvm::cl::opt<std::string>
-    UseStrategy("cf-strategy", llvm::cl::init("random"), llvm::cl::desc("Strategy to use to resolve conflicts."));
+    UseStrategy("cf-strategy", llvm::cl::init("random"), llvm::cl::desc("Strategy to use to resolve conflicts, choose between 'random' (default), 'greedy', 'ilp' and 'lp'"));
+llvm::cl::opt<int> RandomStarts("cf-random-starts", llvm::cl::init(1),
+                                llvm::cl::desc("Independent seeded runs of the 'random' strategy, the best one is kept"));
+llvm::cl::opt<unsigned> RandomSeed("cf-random-seed",
+                                   llvm::cl::desc("Seed of the first run of the 'random' strategy, runs are reproducible"));
+llvm::cl::opt<double> RefineTime("cf-refine-time", llvm::cl::init(0),
+                                 llvm::cl::desc("Seconds of local search improving the selection of the strategy with "
+                                                "add, drop and swap moves, 0 disables it"));
+llvm::cl::opt<double> HotnessPercentile("cf-hotness-percentile", llvm::cl::init(0),
+                                        llvm::cl::desc("Drops manifests in blocks hotter than this percentile of all "
+                                                       "block frequencies before resolving conflicts, 0 disables it"));
+llvm::cl::opt<uint64_t> HotnessLimit("cf-hotness-limit", llvm::cl::init(0),
+                                     llvm::cl::desc("Drops manifests in blocks with a higher frequency before "
+                                                    "resolving conflicts, 0 disables it"));
+llvm::cl::opt<std::string> BlockFrequencies("cf-block-freq", llvm::cl::init("auto"),
+                                            llvm::cl::desc("Source of the block frequencies, choose between 'auto' "
+                                                           "(default, the profile if the module has one, otherwise "
+                                                           "'static'), 'profile' and 'static' (branch heuristics "
+                                                           "scaled along the call graph)"));
+llvm::cl::opt<std::string> HotnessProfile("cf-hotness-profile",
+                                          llvm::cl::desc("JSON file with block frequencies, e.g. converted from "
+                                                         "sampling, used instead of -cf-block-freq"));
+llvm::cl::opt<std::string> OverheadModel("cf-overhead-model", llvm::cl::init("hotness"),
+                                         llvm::cl::desc("Overhead of a manifest, choose between 'hotness' (default, "
+                                                        "normalized block frequencies) and 'dynamic' (estimated extra "
+                                                        "dynamic cycles, also the unit of -cf-ilp-overhead-bound)"));
 llvm::cl::opt<std::string> PatchInfo("cf-patchinfo", llvm::cl::init("cf-patchinfo.json"),
                                      llvm::cl::desc("Dumps the patching information to the given file."));
 
 llvm::cl::opt<std::string> ILPProblem("cf-ilp-prob", llvm::cl::Hidden);
 llvm::cl::opt<std::string> ILPSolution("cf-ilp-sol", llvm::cl::Hidden);
 llvm::cl::opt<std::string> ILPSolutionReadable("cf-ilp-sol-readable", llvm::cl::Hidden);
-llvm::cl::opt<std::string> ILPObjective("cf-ilp-obj", llvm::cl::init("overhead"), llvm::cl::desc("ILP objective function choose between min 'overhead' (default),  max 'explicit', max 'implicit', max 'connectivity'"));
+llvm::cl::list<double> ILPSweep("cf-ilp-sweep", llvm::cl::CommaSeparated,
+                                llvm::cl::desc("Bounds to re-solve the final ILP model with after solving it with "
+                                               "the configured bounds, e.g. 0.5,1,2"));
+llvm::cl::opt<std::string> ILPSweepBound("cf-ilp-sweep-bound", llvm::cl::init("overhead"),
+                                         llvm::cl::desc("Bound varied by -cf-ilp-sweep, choose between 'overhead' "
+                                                        "(default), 'explicit' and 'implicit'"));
+llvm::cl::opt<std::string> ILPSweepOut("cf-ilp-sweep-out", llvm::cl::init("cf-ilp-pareto.json"),
+                                       llvm::cl::desc("Dumps the Pareto table of -cf-ilp-sweep to the given file."));
+llvm::cl::opt<std::string> ILPCache("cf-ilp-cache", llvm::cl::desc("Directory caching the ILP solutions of unchanged models"));
+llvm::cl::opt<std::string> ILPCheckpoint("cf-ilp-checkpoint",
+                                         llvm::cl::desc("File the ILP solver saves every improved solution to, a "
+                                                        "restarted solve of the same model starts from it"));
+llvm::cl::opt<bool> ILPCheckpointAccept("cf-ilp-checkpoint-accept",
+                                        llvm::cl::desc("Uses the solution of -cf-ilp-checkpoint without solving if it "
+                                                       "belongs to the same model"));
+llvm::cl::opt<bool> ILPBreakSymmetry("cf-ilp-break-symmetry",
+                                     llvm::cl::desc("Solves interchangeable manifests as one integer count"));
+llvm::cl::opt<std::string> ILPFormulation("cf-ilp-formulation", llvm::cl::init("legacy"),
+                                          llvm::cl::desc("Linearization of the coverage rows, choose between 'legacy' "
+                                                         "(default, fewer rows) and 'tight' (one row per manifest "
+                                                         "and group)"));
+llvm::cl::opt<std::string> ILPCoverage("cf-ilp-coverage", llvm::cl::init("instruction"),
+                                       llvm::cl::desc("Granularity of the coverage modeled by the ILP, choose between "
+                                                      "'instruction' (default) and 'block' (approximates coverage per "
+                                                      "basic block, weighted by its instructions)"));
+llvm::cl::opt<int> ILPPortfolio("cf-ilp-portfolio", llvm::cl::init(1),
+                                llvm::cl::desc("Solves the ILP with this many branch-and-bound settings on separate "
+                                               "threads, the first optimal one wins"));
+llvm::cl::opt<double> ILPTimeLimit("cf-ilp-time-limit", llvm::cl::init(0),
+                                   llvm::cl::desc("Time limit of the ILP solver in seconds, the best incumbent is "
+                                                  "used once it is hit. 0 disables the limit"));
+llvm::cl::opt<bool> ILPElastic("cf-ilp-elastic",
+                               llvm::cl::desc("Adds slack to the explicit, implicit and overhead bounds, the least "
+                                              "violation is found first and the objective optimized within it, "
+                                              "violated bounds are reported instead of failing"));
+llvm::cl::opt<std::string> ILPBackend("cf-ilp-backend", llvm::cl::init("glpk"), llvm::cl::desc("ILP backend to use, choose between 'glpk' (default) and 'highs'"));
+llvm::cl::opt<std::string> LPMethod("cf-lp-method", llvm::cl::init("simplex"),
+                                    llvm::cl::desc("LP algorithm of the 'lp' strategy, choose between 'simplex' "
+                                                   "(default) and 'interior'"));
+llvm::cl::opt<std::string> LPRounding("cf-lp-rounding", llvm::cl::init("threshold"),
+                                      llvm::cl::desc("Rounding of the 'lp' strategy, choose between 'threshold' "
+                                                     "(default, keeps values >= 0.5) and 'random' (keeps a value "
+                                                     "with its probability, seeded by -cf-random-seed)"));
+llvm::cl::opt<std::string> ILPObjective("cf-ilp-obj", llvm::cl::init("overhead"), llvm::cl::desc("ILP objective function choose between min 'overhead' (default),  max 'explicit', max 'implicit', max 'connectivity', max 'manifest', min 'size'"));
 
 /*
  * List of ILP options
@@ -31,9 +99,15 @@ llvm::cl::opt<int>
     ILPImplicitBound("cf-ilp-implicit-bound", llvm::cl::init(0), llvm::cl::desc("Implicit Coverage"));
 llvm::cl::opt<double>
     ILPConnectivityBound("cf-ilp-connectivity-bound", llvm::cl::init(0), llvm::cl::desc("Instruction Connectivity"));
+llvm::cl::opt<int> ILPConnectivityCap(
+    "cf-ilp-connectivity-cap", llvm::cl::init(0),
+    llvm::cl::desc("Manifests counted per instruction by the 'connectivity' objective, 0 counts all of them"));
 llvm::cl::opt<int>
     ILPExplicitBound("cf-ilp-explicit-bound", llvm::cl::init(0), llvm::cl::desc("Explicit coverage constraint"));
 llvm::cl::opt<double>
     ILPOverheadBound("cf-ilp-overhead-bound", llvm::cl::init(0), llvm::cl::desc("Overhead constraint"));
+llvm::cl::opt<int> ILPSizeBound("cf-ilp-size-bound", llvm::cl::init(0),
+                                llvm::cl::desc("Maximal number of instructions the accepted manifests may add, 0 "
+                                               "disables it"));
 
 } // namespace composition::support
@@ -0,0 +1,215 @@
+#include <catch2/catch.hpp>
+#include <composition/graph/algorithm/greedy.hpp>
+
+using composition::graph::algorithm::Greedy;
+
+TEST_CASE("Greedy drops the cheaper manifest of a conflict with its cascade", "[greedy]") {
+  Greedy<int> greedy{};
+  greedy.addManifest(1, 1.0);
+  greedy.addManifest(2, 1.0);
+  greedy.addManifest(3, 1.0);
+  greedy.addCoverage({1}, 10);
+  greedy.addCoverage({2}, 2);
+  greedy.addCoverage({3}, 2);
+  // 3 is undone together with 2
+  greedy.addDependent(2, 3);
+  greedy.addConflict(1, 2);
+
+  auto result = greedy.run({});
+  REQUIRE(result.accepted == std::set<int>{1});
+  REQUIRE(result.conflicts == 1);
+  REQUIRE(result.explicitC == 10);
+}
+
+TEST_CASE("Greedy breaks cycles formed by owned arcs", "[greedy]") {
+  Greedy<int> greedy{};
+  greedy.addManifest(1, 0.5);
+  greedy.addManifest(2, 1.5);
+  greedy.addCoverage({1}, 4);
+  greedy.addCoverage({2}, 4);
+
+  auto a12 = greedy.addArc(0, 1);
+  // 1 -> 2 has no owner, e.g., a hierarchy arc
+  greedy.addArc(1, 2);
+  auto a20 = greedy.addArc(2, 0);
+  greedy.addArcOwner(a12, 1);
+  greedy.addArcOwner(a20, 2);
+
+  auto result = greedy.run({});
+  REQUIRE(result.accepted == std::set<int>{1});
+  REQUIRE(result.cycles == 1);
+}
+
+TEST_CASE("Greedy trims overhead without violating the explicit bound", "[greedy]") {
+  Greedy<int> greedy{};
+  greedy.addManifest(1, 1.0);
+  greedy.addManifest(2, 1.0);
+  greedy.addManifest(3, 1.0);
+  greedy.addCoverage({1}, 5);
+  greedy.addCoverage({2}, 3);
+  greedy.addCoverage({3}, 1);
+
+  Greedy<int>::Bounds bounds{};
+  bounds.overhead = 1.0;
+  bounds.explicitC = 8;
+  auto result = greedy.run(bounds);
+  REQUIRE(result.accepted == std::set<int>{1, 2});
+  REQUIRE(result.explicitC == 8);
+  REQUIRE_FALSE(result.boundsMet);
+}
+
+TEST_CASE("Randomized resolution is reproducible from its seed", "[greedy]") {
+  Greedy<int> greedy{};
+  for (int m = 0; m < 20; ++m) {
+    greedy.addManifest(m, 1.0);
+    greedy.addCoverage({m}, 1);
+  }
+  for (int m = 0; m + 1 < 20; ++m) {
+    greedy.addConflict(m, m + 1);
+  }
+
+  auto first = greedy;
+  first.randomize(42);
+  auto second = greedy;
+  second.randomize(42);
+
+  auto result = first.run({});
+  REQUIRE(result.accepted == second.run({}).accepted);
+  for (int m = 0; m + 1 < 20; ++m) {
+    REQUIRE((result.accepted.count(m) == 0 || result.accepted.count(m + 1) == 0));
+  }
+}
+
+TEST_CASE("Excluded manifests stay dropped together with their dependents", "[greedy]") {
+  Greedy<int> greedy{};
+  greedy.addManifest(1, 1.0);
+  greedy.addManifest(2, 1.0);
+  greedy.addManifest(3, 1.0);
+  greedy.addCoverage({1}, 10);
+  greedy.addCoverage({2}, 2);
+  greedy.addCoverage({3}, 2);
+  greedy.addDependent(1, 3);
+  greedy.addConflict(1, 2);
+
+  greedy.exclude(1);
+  auto result = greedy.run({});
+  REQUIRE(result.accepted == std::set<int>{2});
+  REQUIRE(result.conflicts == 0);
+  REQUIRE(result.explicitC == 2);
+}
+
+TEST_CASE("Refinement swaps a manifest for its more covering conflict partner", "[greedy]") {
+  Greedy<int> greedy{};
+  greedy.addManifest(1, 1.0);
+  greedy.addManifest(2, 1.0);
+  greedy.addManifest(3, 1.0);
+  greedy.addCoverage({1}, 2);
+  greedy.addCoverage({2}, 10);
+  greedy.addCoverage({3}, 1);
+  greedy.addConflict(1, 2);
+
+  // Another strategy rejected 2 and 3
+  greedy.exclude(2);
+  greedy.exclude(3);
+  auto result = greedy.refine({}, 10.0);
+  REQUIRE(result.accepted == std::set<int>{2, 3});
+  REQUIRE(result.explicitC == 11);
+  REQUIRE(result.moves == 2);
+}
+
+TEST_CASE("Refinement does not accept manifests closing a cycle", "[greedy]") {
+  Greedy<int> greedy{};
+  greedy.addManifest(1, 1.0);
+  greedy.addManifest(2, 1.0);
+  greedy.addCoverage({1}, 4);
+  greedy.addCoverage({2}, 4);
+
+  auto a01 = greedy.addArc(0, 1);
+  auto a10 = greedy.addArc(1, 0);
+  greedy.addArcOwner(a01, 1);
+  greedy.addArcOwner(a10, 2);
+
+  greedy.exclude(2);
+  auto result = greedy.refine({}, 10.0);
+  REQUIRE(result.accepted == std::set<int>{1});
+  REQUIRE(result.moves == 0);
+}
+
+TEST_CASE("Refinement drops manifests adding nothing but overhead", "[greedy]") {
+  Greedy<int> greedy{};
+  greedy.addManifest(1, 1.0);
+  greedy.addManifest(2, 3.0);
+  greedy.addCoverage({1, 2}, 5);
+  greedy.addDependent(1, 2);
+
+  auto result = greedy.refine({}, 10.0);
+  REQUIRE(result.accepted == std::set<int>{1});
+  REQUIRE(result.explicitC == 5);
+  REQUIRE(result.overhead == 1.0);
+}
+
+TEST_CASE("Refinement accepts manifests whose arcs keep the graph acyclic", "[greedy]") {
+  Greedy<int> greedy{};
+  greedy.addManifest(1, 1.0);
+  greedy.addManifest(2, 1.0);
+  greedy.addManifest(3, 1.0);
+  greedy.addCoverage({1}, 4);
+  greedy.addCoverage({2}, 4);
+  greedy.addCoverage({3}, 4);
+
+  greedy.addArcOwner(greedy.addArc(0, 1), 1);
+  greedy.addArcOwner(greedy.addArc(1, 2), 2);
+  greedy.addArcOwner(greedy.addArc(2, 0), 3);
+
+  greedy.exclude(2);
+  greedy.exclude(3);
+  auto result = greedy.refine({}, 10.0);
+  // Either of 2 and 3 fits, both close the cycle
+  REQUIRE(result.accepted.size() == 2);
+  REQUIRE(result.accepted.count(1) == 1);
+  REQUIRE(result.moves == 1);
+}
+
+TEST_CASE("Refinement keeps the protectors of a met implicit bound", "[greedy]") {
+  Greedy<int> greedy{};
+  greedy.addManifest(1, 1.0);
+  greedy.addManifest(2, 1.0);
+  greedy.addManifest(3, 1.0);
+  greedy.addCoverage({1}, 6);
+  greedy.addProtection(1, 2);
+  greedy.addProtection(1, 3);
+
+  Greedy<int>::Bounds bounds{};
+  bounds.implicitC = 6;
+  auto result = greedy.refine(bounds, 10.0);
+  // One protector is enough, dropping the other saves overhead
+  REQUIRE(result.accepted.size() == 2);
+  REQUIRE(result.accepted.count(1) == 1);
+  REQUIRE(result.implicitC == 6);
+  REQUIRE(result.boundsMet);
+
+  // run only drops, the coverage is gone together with its manifest
+  greedy.exclude(1);
+  REQUIRE(greedy.run(bounds).implicitC == 0);
+}
+
+TEST_CASE("Weighted implicit coverage keeps protectors in conflicts", "[greedy]") {
+  Greedy<int> greedy{};
+  greedy.addManifest(1, 1.0);
+  greedy.addManifest(2, 1.0);
+  greedy.addManifest(3, 1.0);
+  greedy.addCoverage({1}, 1);
+  greedy.addCoverage({2}, 1);
+  greedy.addCoverage({3}, 10);
+  greedy.addProtection(3, 1);
+  greedy.addConflict(1, 2);
+
+  // Explicit coverage alone ties, the first member is dropped
+  auto unweighted = greedy;
+  REQUIRE(unweighted.run({}).accepted == std::set<int>{2, 3});
+
+  greedy.setCoverageWeights(1.0, 1.0);
+  auto result = greedy.run({});
+  REQUIRE(result.accepted == std::set<int>{1, 3});
+  REQUIRE(result.implicitC == 10);
+}
@@ -0,0 +1,128 @@
+#include <catch2/catch.hpp>
+#include <composition/graph/ilp/Symmetry.hpp>
+#include <functional>
+#include <limits>
+
+using composition::graph::ilp::BoundType;
+using composition::graph::ilp::collapseSymmetries;
+using composition::graph::ilp::ColumnKind;
+using composition::graph::ilp::Model;
+
+namespace {
+int binary(Model &model, const std::string &name, double objective) {
+  int col = model.addColumn();
+  model.setColumnName(col, name);
+  model.setColumnKind(col, ColumnKind::Binary);
+  model.setColumnBounds(col, BoundType::Double, 0.0, 1.0);
+  model.setObjective(col, objective);
+  return col;
+}
+
+int row(Model &model, BoundType type, double lb, double ub, const std::vector<std::pair<int, double>> &entries) {
+  int r = model.addRow();
+  model.setRowBounds(r, type, lb, ub);
+  for (auto &[col, coefficient] : entries) {
+    model.addCoefficient(r, col, coefficient);
+  }
+  return r;
+}
+
+/**
+ * Minimal objective of a small integer model by enumeration, infinity if infeasible
+ */
+double optimum(const Model &model) {
+  std::vector<double> values(model.columns.size());
+  double best = std::numeric_limits<double>::infinity();
+  std::function<void(size_t)> assign = [&](size_t c) {
+    if (c == values.size()) {
+      std::vector<double> activity(model.rows.size(), 0.0);
+      for (size_t k = 0; k < model.numCoefficients(); ++k) {
+        activity[model.matrixRows[k] - 1] += model.matrixCoeffs[k] * values[model.matrixCols[k] - 1];
+      }
+      for (size_t r = 0; r < model.rows.size(); ++r) {
+        auto &row = model.rows[r];
+        bool lower = row.type == BoundType::Lower || row.type == BoundType::Double || row.type == BoundType::Fixed;
+        bool upper = row.type == BoundType::Upper || row.type == BoundType::Double;
+        if ((lower && activity[r] < row.lb - 1e-9) || (upper && activity[r] > row.ub + 1e-9) ||
+            (row.type == BoundType::Fixed && activity[r] > row.lb + 1e-9)) {
+          return;
+        }
+      }
+      double objective = 0.0;
+      for (size_t i = 0; i < values.size(); ++i) {
+        objective += model.columns[i].objective * values[i];
+      }
+      best = std::min(best, objective);
+      return;
+    }
+    for (double v = model.columns[c].lb; v <= model.columns[c].ub; v += 1.0) {
+      values[c] = v;
+      assign(c + 1);
+    }
+  };
+  assign(0);
+  return best;
+}
+
+/**
+ * Three hash checks over the same instructions, covered by `c` with the tight OR rows, and a manifest `x` depending
+ * on all of them
+ */
+Model hashChecks(double xLb) {
+  Model model{};
+  int m1 = binary(model, "m1", 2.0);
+  int m2 = binary(model, "m2", 2.0);
+  int m3 = binary(model, "m3", 2.0);
+  int c = binary(model, "c", 0.0);
+  int x = binary(model, "x", 1.0);
+  model.setColumnBounds(x, BoundType::Double, xLb, 1.0);
+  // explicit >= 5
+  row(model, BoundType::Lower, 5.0, 0.0, {{c, 5.0}, {m1, 0.0}, {m2, 0.0}, {m3, 0.0}});
+  row(model, BoundType::Upper, 0.0, 0.0, {{c, 1.0}, {m1, -1.0}, {m2, -1.0}, {m3, -1.0}});
+  for (int m : {m1, m2, m3}) {
+    row(model, BoundType::Lower, 0.0, 0.0, {{c, 1.0}, {m, -1.0}});
+    row(model, BoundType::Upper, 0.0, 0.0, {{x, 1.0}, {m, -1.0}});
+  }
+  return model;
+}
+} // namespace
+
+TEST_CASE("Identical hash checks collapse into one count", "[symmetry]") {
+  auto model = hashChecks(0.0);
+  auto collapsed = collapseSymmetries(model, {{1, 2, 3}});
+  REQUIRE(collapsed.classes == 1);
+  // c, x, the count and its any/all columns
+  REQUIRE(collapsed.model.numColumns() == 5);
+  // Row indices of the original model stay valid
+  REQUIRE(collapsed.model.numRows() >= model.numRows());
+  REQUIRE(optimum(collapsed.model) == optimum(model));
+  REQUIRE(optimum(model) == 2.0);
+
+  // A count of 2 selects the first two members
+  int count = collapsed.origin[0].first;
+  REQUIRE(collapsed.origin[1].first == count);
+  REQUIRE(collapsed.origin[2].first == count);
+  auto values = [&](int col) { return col == count ? 2.0 : 0.0; };
+  REQUIRE(collapsed.value(1, values) == 1.0);
+  REQUIRE(collapsed.value(2, values) == 1.0);
+  REQUIRE(collapsed.value(3, values) == 0.0);
+}
+
+TEST_CASE("Rows repeated per member keep their meaning after collapsing", "[symmetry]") {
+  // x is forced and needs every hash check
+  auto model = hashChecks(1.0);
+  auto collapsed = collapseSymmetries(model, {{1, 2, 3}});
+  REQUIRE(collapsed.classes == 1);
+  REQUIRE(optimum(model) == 7.0);
+  REQUIRE(optimum(collapsed.model) == 7.0);
+}
+
+TEST_CASE("Classes whose members differ in a row are not collapsed", "[symmetry]") {
+  auto model = hashChecks(0.0);
+  // Only m1 conflicts with x
+  row(model, BoundType::Upper, 0.0, 1.0, {{1, 1.0}, {5, 1.0}});
+  auto collapsed = collapseSymmetries(model, {{1, 2, 3}});
+  REQUIRE(collapsed.classes == 0);
+  REQUIRE(collapsed.model.numColumns() == model.numColumns());
+  REQUIRE(optimum(collapsed.model) == optimum(model));
+}